@@ -0,0 +1,141 @@
+/*
+  Copyright (c) 2014-2018 NicoHood
+  See the readme for credit to other people.
+
+  IRL Benchmark_ISR
+
+  Measures the CPU cycles of the IR interrupt function while you press buttons
+  on your remote and prints the statistics every few seconds.
+  Run it once with and once without IRL_DEFERRED_DECODE to compare decoding
+  inside the interrupt with deferred decoding in the main loop.
+  Measure HashIR with and without IRL_HASHIR_LAZY to see the cost of the
+  32 bit hash multiplication on every edge.
+
+  Timer1 is used to count the cycles, this only works on AVR boards.
+  PWM on the Timer1 pins (9 and 10 on an Uno) is not available.
+*/
+
+// Uncomment to only save the edge durations inside the interrupt
+//#define IRL_DEFERRED_DECODE 64
+
+// Uncomment to measure HashIR instead of NEC,
+// optionally without the 32 bit hash multiplication inside the interrupt
+//#define BENCHMARK_HASHIR
+//#define IRL_HASHIR_LAZY
+
+#include "IRLremote.h"
+
+#ifndef ARDUINO_ARCH_AVR
+#error "This example requires an AVR board with Timer1."
+#endif
+
+// Choose a valid PinInterrupt pin of your Arduino board
+#define pinIR 2
+
+#ifdef BENCHMARK_HASHIR
+typedef CHashIR CProtocol;
+#else
+typedef CNec CProtocol;
+#endif
+
+// Expose the interrupt function for measuring
+class CBench : public CProtocol {
+public:
+  using CProtocol::interrupt;
+  using CProtocol::interruptMode;
+};
+CBench IRLremote;
+
+volatile uint16_t cyclesMin = 0xFFFF;
+volatile uint16_t cyclesMax = 0;
+volatile uint32_t cyclesSum = 0;
+volatile uint16_t edges = 0;
+uint16_t overhead = 0;
+
+void measure(void)
+{
+  uint16_t start = TCNT1;
+  CBench::interrupt();
+  uint16_t cycles = TCNT1 - start - overhead;
+
+  if (cycles < cyclesMin) {
+    cyclesMin = cycles;
+  }
+  if (cycles > cyclesMax) {
+    cyclesMax = cycles;
+  }
+  cyclesSum += cycles;
+  edges++;
+}
+
+void setup()
+{
+  // Start serial debug output
+  while (!Serial);
+  Serial.begin(115200);
+  Serial.println(F("Startup"));
+
+  // Run Timer1 with the CPU clock
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+
+  // Measure the overhead of reading the timer
+  uint16_t start = TCNT1;
+  uint16_t end = TCNT1;
+  overhead = end - start;
+
+  // Attach the measuring function instead of the plain interrupt
+  pinMode(pinIR, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(pinIR), measure, CBench::interruptMode);
+}
+
+void loop()
+{
+  if (IRLremote.available())
+  {
+    auto data = IRLremote.read();
+    Serial.print(F("Address: 0x"));
+    Serial.print(data.address, HEX);
+    Serial.print(F(" Command: 0x"));
+    Serial.println(data.command, HEX);
+  }
+
+  static uint32_t lastPrint = 0;
+  if (millis() - lastPrint < 3000) {
+    return;
+  }
+  lastPrint = millis();
+
+  // Copy and reset the statistics
+  uint16_t cmin, cmax, count;
+  uint32_t csum;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    cmin = cyclesMin;
+    cmax = cyclesMax;
+    csum = cyclesSum;
+    count = edges;
+    cyclesMin = 0xFFFF;
+    cyclesMax = 0;
+    cyclesSum = 0;
+    edges = 0;
+  }
+  if (!count) {
+    return;
+  }
+
+#ifdef IRL_DEFERRED_DECODE
+  Serial.print(F("Deferred "));
+#endif
+#ifdef IRL_HASHIR_LAZY
+  Serial.print(F("Lazy "));
+#endif
+  Serial.print(F("Edges: "));
+  Serial.print(count);
+  Serial.print(F(" Cycles min: "));
+  Serial.print(cmin);
+  Serial.print(F(" avg: "));
+  Serial.print(csum / count);
+  Serial.print(F(" max: "));
+  Serial.println(cmax);
+}
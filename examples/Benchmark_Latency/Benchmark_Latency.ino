@@ -0,0 +1,120 @@
+/*
+  Copyright (c) 2014-2018 NicoHood
+  See the readme for credit to other people.
+
+  IRL Benchmark_Latency
+
+  Measures the worst case latency of another interrupt while the main loop
+  polls read(), receiving() and timeout() as fast as possible.
+  The library reads the interrupt data lock-free and only disables interrupts
+  for a few instructions when the decoding state changes. Uncomment
+  BENCHMARK_ATOMIC to wrap the polling in an atomic block, like the library
+  did before, and compare the numbers.
+
+  Timer2 fires every 100us, its interrupt saves the timer count at entry.
+  The latency is printed in 0.5us ticks (16MHz) and includes the interrupt
+  entry and the IR interrupt itself, if you press buttons on your remote.
+  This only works on AVR boards, PWM on the Timer2 pins is not available.
+*/
+
+// Uncomment to disable interrupts while polling, as a reference
+//#define BENCHMARK_ATOMIC
+
+#include "IRLremote.h"
+
+#ifndef ARDUINO_ARCH_AVR
+#error "This example requires an AVR board with Timer2."
+#endif
+
+// Choose a valid PinInterrupt pin of your Arduino board
+#define pinIR 2
+
+CNec IRLremote;
+
+volatile uint8_t latencyMax = 0;
+volatile uint32_t latencySum = 0;
+volatile uint16_t samples = 0;
+
+ISR(TIMER2_COMPA_vect)
+{
+  // The counter was reset at the compare match
+  uint8_t latency = TCNT2;
+  if (latency > latencyMax) {
+    latencyMax = latency;
+  }
+  latencySum += latency;
+  samples++;
+}
+
+void setup()
+{
+  // Start serial debug output
+  while (!Serial);
+  Serial.begin(115200);
+  Serial.println(F("Startup"));
+
+  // Start reading the remote. PinInterrupt or PinChangeInterrupt* will automatically be selected
+  if (!IRLremote.begin(pinIR))
+    Serial.println(F("You did not choose a valid pin."));
+
+  // Timer2 in CTC mode, prescaler 8, interrupt every 100us at 16MHz
+  TCCR2A = _BV(WGM21);
+  TCCR2B = _BV(CS21);
+  OCR2A = F_CPU / 8 / 10000 - 1;
+  TIMSK2 = _BV(OCIE2A);
+}
+
+void loop()
+{
+  // The same calls as the examples do in a tight loop
+  Nec_data_t data;
+#ifdef BENCHMARK_ATOMIC
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#endif
+  {
+    IRLremote.receiving();
+    IRLremote.timeout();
+    data = IRLremote.read();
+  }
+
+  if (data.address || data.command)
+  {
+    Serial.print(F("Address: 0x"));
+    Serial.print(data.address, HEX);
+    Serial.print(F(" Command: 0x"));
+    Serial.println(data.command, HEX);
+  }
+
+  static uint32_t lastPrint = 0;
+  if (millis() - lastPrint < 3000) {
+    return;
+  }
+  lastPrint = millis();
+
+  // Copy and reset the statistics
+  uint8_t lmax;
+  uint32_t lsum;
+  uint16_t count;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    lmax = latencyMax;
+    lsum = latencySum;
+    count = samples;
+    latencyMax = 0;
+    latencySum = 0;
+    samples = 0;
+  }
+  if (!count) {
+    return;
+  }
+
+#ifdef BENCHMARK_ATOMIC
+  Serial.print(F("Atomic "));
+#endif
+  Serial.print(F("Samples: "));
+  Serial.print(count);
+  Serial.print(F(" Latency avg: "));
+  Serial.print(lsum / count);
+  Serial.print(F(" max: "));
+  Serial.println(lmax);
+}
@@ -36,7 +36,9 @@
 CNec IRLremote;
 //CPanasonic IRLremote;
 //CHashIR IRLremote;
-//#define IRLremote Sony12
+//CSony IRLremote;
+//CRC5 IRLremote;
+//CRC6 IRLremote;
 
 #define pinLed LED_BUILTIN
 
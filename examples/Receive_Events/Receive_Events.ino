@@ -0,0 +1,93 @@
+/*
+  Copyright (c) 2014-2018 NicoHood
+  See the readme for credit to other people.
+
+  IRL Receive_Events
+
+  Detects button presses, holds and releases of any protocol and prints the
+  events to the Serial monitor. The events are queued, so the loop can do
+  other work and process all events at once.
+
+  The following pins are usable for PinInterrupt or PinChangeInterrupt*:
+  Arduino Uno/Nano/Mini: All pins are usable
+  Arduino Mega: 10, 11, 12, 13, 50, 51, 52, 53, A8 (62), A9 (63), A10 (64),
+              A11 (65), A12 (66), A13 (67), A14 (68), A15 (69)
+  Arduino Leonardo/Micro: 8, 9, 10, 11, 14 (MISO), 15 (SCK), 16 (MOSI)
+  HoodLoader2: All (broken out 1-7) pins are usable
+  Attiny 24/44/84: All pins are usable
+  Attiny 25/45/85: All pins are usable
+  Attiny 13: All pins are usable
+  Attiny 441/841: All pins are usable
+  ATmega644P/ATmega1284P: All pins are usable
+
+  PinChangeInterrupts* requires a special library which can be downloaded here:
+  https://github.com/NicoHood/PinChangeInterrupt
+*/
+
+// include PinChangeInterrupt library* BEFORE IRLremote to acces more pins if needed
+//#include "PinChangeInterrupt.h"
+
+#include "IRLremote.h"
+
+// Choose a valid PinInterrupt or PinChangeInterrupt* pin of your Arduino board
+#define pinIR 2
+
+// Choose the IR protocol of your remote
+CIRL_Events<CNec> IRLremote;
+//CIRL_Events<CPanasonic> IRLremote;
+//CIRL_Events<CHashIR> IRLremote;
+//CIRL_Events<CSony> IRLremote;
+//CIRL_Events<CRC5> IRLremote;
+//CIRL_Events<CRC6> IRLremote;
+
+void setup()
+{
+  // Start serial debug output
+  while (!Serial);
+  Serial.begin(115200);
+  Serial.println(F("Startup"));
+
+  // Start reading the remote. PinInterrupt or PinChangeInterrupt* will automatically be selected
+  if (!IRLremote.begin(pinIR))
+    Serial.println(F("You did not choose a valid pin."));
+}
+
+void loop()
+{
+  // Process all new events
+  IRL_Event_t event;
+  while (IRLremote.readEvent(event))
+  {
+    switch (event.type)
+    {
+      case IRL_EVENT_PRESS:
+        Serial.print(F("Press "));
+        Serial.print(event.count);
+        Serial.print(F("x "));
+        break;
+      case IRL_EVENT_HOLD:
+        Serial.print(F("Hold "));
+        Serial.print(event.duration);
+        Serial.print(F(" "));
+        break;
+      case IRL_EVENT_RELEASE:
+        Serial.print(F("Release "));
+        break;
+      case IRL_EVENT_END:
+        Serial.print(F("End of "));
+        Serial.print(event.count);
+        Serial.print(F(" presses "));
+        break;
+      default:
+        break;
+    }
+
+    Serial.print(F("Address: 0x"));
+    Serial.print(event.address, HEX);
+    Serial.print(F(" Command: 0x"));
+    Serial.println(event.command, HEX);
+  }
+
+  // Do other work here
+  delay(50);
+}
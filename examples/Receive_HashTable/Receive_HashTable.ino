@@ -0,0 +1,80 @@
+/*
+  Copyright (c) 2014-2018 NicoHood
+  See the readme for credit to other people.
+
+  IRL Receive_HashTable
+
+  Maps learned HashIR codes to actions with a table in flash (PROGMEM)
+  instead of a long if/switch chain. Learn the hashes with the Receive example
+  (CHashIR) and add them to the table, sorted by hash.
+
+  For hundreds of codes generate a perfect hash table (constant time lookup)
+  with extra/host/HashTable_Gen.cpp and include the generated header instead:
+  ./HashTable_Gen remote codes.txt > Remote_Codes.h
+*/
+
+#include "IRLremote.h"
+
+// Choose a valid PinInterrupt or PinChangeInterrupt* pin of your Arduino board
+#define pinIR 2
+
+CHashIR IRLremote;
+
+// Actions of the sketch
+enum Action : uint16_t {
+  ACTION_POWER,
+  ACTION_VOLUME_UP,
+  ACTION_VOLUME_DOWN,
+  ACTION_MUTE,
+};
+
+// Learned hashes, sorted by hash
+static constexpr IRL_HashCode_t codes[] PROGMEM = {
+  { 0x2EAD5A33, ACTION_VOLUME_UP },
+  { 0x5B3FA0D1, ACTION_POWER },
+  { 0x9C1E7A52, ACTION_MUTE },
+  { 0xE3A4F71D, ACTION_VOLUME_DOWN },
+};
+static_assert(CIRL_HashTable::sorted(codes, sizeof(codes) / sizeof(codes[0])),
+              "Hashes are not sorted");
+static constexpr CIRL_HashTable table(codes, sizeof(codes) / sizeof(codes[0]));
+
+void setup()
+{
+  // Start serial debug output
+  while (!Serial);
+  Serial.begin(115200);
+  Serial.println(F("Startup"));
+
+  // Start reading the remote. PinInterrupt or PinChangeInterrupt* will automatically be selected
+  if (!IRLremote.begin(pinIR))
+    Serial.println(F("You did not choose a valid pin."));
+}
+
+void loop()
+{
+  if (IRLremote.available())
+  {
+    auto data = IRLremote.read();
+
+    switch (table.lookup(data.command))
+    {
+      case ACTION_POWER:
+        Serial.println(F("Power"));
+        break;
+      case ACTION_VOLUME_UP:
+        Serial.println(F("Volume up"));
+        break;
+      case ACTION_VOLUME_DOWN:
+        Serial.println(F("Volume down"));
+        break;
+      case ACTION_MUTE:
+        Serial.println(F("Mute"));
+        break;
+      case IRL_HASHTABLE_NONE:
+        Serial.print(F("Unknown hash: 0x"));
+        Serial.println(data.command, HEX);
+        break;
+    }
+  }
+}
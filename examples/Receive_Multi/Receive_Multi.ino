@@ -0,0 +1,99 @@
+/*
+  Copyright (c) 2014-2018 NicoHood
+  See the readme for credit to other people.
+
+  IRL Receive_Multi
+
+  Receives IR signals of multiple protocols on a single pin and prints them
+  to the Serial monitor. All protocols share one interrupt function.
+  Remove the not used protocols to save flash/ram/speed.
+
+  The following pins are usable for PinInterrupt or PinChangeInterrupt*:
+  Arduino Uno/Nano/Mini: All pins are usable
+  Arduino Mega: 10, 11, 12, 13, 50, 51, 52, 53, A8 (62), A9 (63), A10 (64),
+              A11 (65), A12 (66), A13 (67), A14 (68), A15 (69)
+  Arduino Leonardo/Micro: 8, 9, 10, 11, 14 (MISO), 15 (SCK), 16 (MOSI)
+  HoodLoader2: All (broken out 1-7) pins are usable
+  Attiny 24/44/84: All pins are usable
+  Attiny 25/45/85: All pins are usable
+  Attiny 13: All pins are usable
+  Attiny 441/841: All pins are usable
+  ATmega644P/ATmega1284P: All pins are usable
+
+  PinChangeInterrupts* requires a special library which can be downloaded here:
+  https://github.com/NicoHood/PinChangeInterrupt
+*/
+
+// include PinChangeInterrupt library* BEFORE IRLremote to acces more pins if needed
+//#include "PinChangeInterrupt.h"
+
+#include "IRLremote.h"
+
+// Choose a valid PinInterrupt or PinChangeInterrupt* pin of your Arduino board
+#define pinIR 2
+
+// The multi receiver attaches the interrupt for all protocols.
+// Do not call begin() of the single protocols.
+CIRL_Multi<CNec, CPanasonic, CHashIR> IRLremote;
+CNec nec;
+CPanasonic panasonic;
+CHashIR hash;
+
+#define pinLed LED_BUILTIN
+
+void setup()
+{
+  // Start serial debug output
+  while (!Serial);
+  Serial.begin(115200);
+  Serial.println(F("Startup"));
+
+  // Set LED to output
+  pinMode(pinLed, OUTPUT);
+
+  // Start reading the remote. PinInterrupt or PinChangeInterrupt* will automatically be selected
+  if (!IRLremote.begin(pinIR))
+    Serial.println(F("You did not choose a valid pin."));
+}
+
+void loop()
+{
+  // Check if new IR protocol data is available
+  if (IRLremote.available())
+  {
+    // Light Led
+    digitalWrite(pinLed, HIGH);
+
+    // Known protocols first. The hash also recognizes these frames,
+    // so only print the hash if no other protocol matched.
+    if (nec.available())
+    {
+      auto data = nec.read();
+      Serial.print(F("NEC Address: 0x"));
+      Serial.print(data.address, HEX);
+      Serial.print(F(" Command: 0x"));
+      Serial.println(data.command, HEX);
+      hash.read();
+    }
+    else if (panasonic.available())
+    {
+      auto data = panasonic.read();
+      Serial.print(F("Panasonic Address: 0x"));
+      Serial.print(data.address, HEX);
+      Serial.print(F(" Command: 0x"));
+      Serial.println(data.command, HEX);
+      hash.read();
+    }
+    else if (hash.available())
+    {
+      auto data = hash.read();
+      Serial.print(F("Hash Length: "));
+      Serial.print(data.address);
+      Serial.print(F(" Command: 0x"));
+      Serial.println(data.command, HEX);
+    }
+
+    // Turn Led off after printing the data
+    digitalWrite(pinLed, LOW);
+  }
+}
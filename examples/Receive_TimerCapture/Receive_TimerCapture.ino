@@ -0,0 +1,61 @@
+/*
+  Copyright (c) 2014-2018 NicoHood
+  See the readme for credit to other people.
+
+  IRL Receive_TimerCapture
+
+  Receives IR signals with the hardware input capture of Timer1.
+  The timer latches the time of every edge, so the durations are exact and
+  independent of the interrupt latency (other interrupts, micros()).
+
+  Connect the IR receiver to the input capture pin (ICP1):
+  Arduino Uno/Nano/Mini: pin 8
+  Arduino Leonardo/Micro: pin 4
+
+  Timer1 can not be used by other libraries (Servo) at the same time.
+  Experimental: not verified on hardware or in a simulator yet.
+*/
+
+// Use Timer1 input capture, define before including IRLremote
+#define IRL_TIMER_CAPTURE
+#include "IRLremote.h"
+
+// Timer1 capture and overflow interrupts, only in a single source file
+IRL_TIMER_CAPTURE_INTERRUPTS
+
+// The input capture pin of your Arduino board
+#define pinIR IRL_TIMER_CAPTURE_PIN
+
+// Choose the IR protocol of your remote. Only a single receiver is possible.
+CNec IRLremote;
+//CPanasonic IRLremote;
+//CHashIR IRLremote;
+
+void setup()
+{
+  // Start serial debug output
+  while (!Serial);
+  Serial.begin(115200);
+  Serial.println(F("Startup"));
+
+  // Start reading the remote with the input capture
+  if (!IRLremote.begin(pinIR))
+    Serial.println(F("You did not choose the input capture pin."));
+}
+
+void loop()
+{
+  // Check if new IR protocol data is available
+  if (IRLremote.available())
+  {
+    // Get the new data from the remote
+    auto data = IRLremote.read();
+
+    // Print the protocol data
+    Serial.print(F("Address: 0x"));
+    Serial.println(data.address, HEX);
+    Serial.print(F("Command: 0x"));
+    Serial.println(data.command, HEX);
+    Serial.println();
+  }
+}
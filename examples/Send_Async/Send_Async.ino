@@ -0,0 +1,69 @@
+/*
+  Copyright (c) 2014-2018 NicoHood
+  See the readme for credit to other people.
+
+  IRL Send Async
+
+  Sends a NEC frame without blocking or disabling interrupts.
+  Write anything to the Serial port and hit enter to send data.
+  The mark/space schedule is sent by the Timer1 compare interrupt,
+  the carrier is generated by Timer2 hardware PWM.
+
+  The carrier pin is fixed (OC2B):
+  Arduino Uno/Nano/Mini: 3
+  Arduino Mega: 9
+
+  Timer1 and Timer2 can not be used by other libraries (Servo, tone()).
+*/
+
+#include "IRLremote.h"
+
+#include "IRL_Send.h"
+
+// Defines the timer interrupt, only use it in a single source file
+IRL_SEND_INTERRUPT
+
+#define pinLed LED_BUILTIN
+
+// Timings are generated from the IRP notation at compile time
+const IRL_Timing_t timing = CIRL_IRP::timing(NEC_IRP);
+
+void sendDone(void)
+{
+  // Called from the timer interrupt, keep it short
+  digitalWrite(pinLed, LOW);
+}
+
+void setup()
+{
+  // Start serial debug output
+  while (!Serial);
+  Serial.begin(115200);
+  Serial.println(F("Startup"));
+
+  pinMode(pinLed, OUTPUT);
+
+  // Setup the timers and the carrier pin
+  CIRL_Sender::begin();
+}
+
+void loop()
+{
+  if (Serial.available())
+  {
+    // Discard all Serial bytes to avoid multiple sendings
+    delay(10);
+    while (Serial.available()) {
+      Serial.read();
+    }
+
+    // Address 0x6361, command 0x01 and its inverse
+    uint8_t data[4] = { 0x61, 0x63, 0x01, 0xFE };
+
+    // Returns immediately, false if the previous frame is still sent
+    digitalWrite(pinLed, HIGH);
+    if (CIRL_Sender::write(timing, data, sendDone)) {
+      Serial.println(F("Sending..."));
+    }
+  }
+}
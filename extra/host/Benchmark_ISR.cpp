@@ -0,0 +1,200 @@
+/*
+  Copyright (c) 2014-2018 NicoHood
+  See the readme for credit to other people.
+
+  IRL Benchmark_ISR
+
+  Measures the cycles that the NEC and HashIR interrupt functions take per edge.
+  Compile it twice to compare decoding inside the interrupt with deferred
+  decoding, where the interrupt only saves the edge duration:
+
+  g++ -std=gnu++11 -O2 -I../../src Benchmark_ISR.cpp ../../src/IRLremote.cpp -o Benchmark_ISR
+  g++ -std=gnu++11 -O2 -I../../src -DIRL_DEFERRED_DECODE=64 Benchmark_ISR.cpp ../../src/IRLremote.cpp -o Benchmark_ISR_Deferred
+
+  The numbers are host cycles. They show the relative cost of both modes,
+  the absolute numbers on an AVR are different.
+
+  Add -DIRL_PROFILER to also print the cycles of every decoding branch.
+  Add -DIRL_HASHIR_LAZY to move the HashIR hash calculation into read().
+  A host CPU multiplies fast, use the AVR example for the real difference.
+*/
+
+#include "IRLremote.h"
+#include <stdio.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t cycles(void) { return __rdtsc(); }
+#else
+#include <time.h>
+static inline uint64_t cycles(void) {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+#endif
+
+#define pinNec 2
+#define pinHash 3
+#define FRAMES 10000
+
+// Expose the interrupt functions for measuring
+class CNecBench : public CNec {
+public:
+  using CNec::interrupt;
+  using CNec::interruptMode;
+};
+
+class CHashIRBench : public CHashIR {
+public:
+  using CHashIR::interrupt;
+  using CHashIR::interruptMode;
+};
+
+CNecBench nec;
+CHashIRBench hash;
+
+// Durations are counted in a histogram, the last bucket counts overflows.
+// The maximum is not printed, it only shows the preemption of the host OS.
+#define BUCKETS 1024
+
+struct Result {
+  uint64_t min = ~0ULL;
+  uint64_t sum = 0;
+  uint32_t edges = 0;
+  uint32_t frames = 0;
+  uint32_t histogram[BUCKETS] = { 0 };
+};
+
+Result resultNec;
+Result resultHash;
+uint64_t overhead = 0;
+
+static inline void measure(Result &result, void(*isr)(void))
+{
+  uint64_t start = cycles();
+  isr();
+  uint64_t duration = cycles() - start;
+  duration = duration > overhead ? duration - overhead : 0;
+
+  if (duration < result.min) {
+    result.min = duration;
+  }
+  result.histogram[duration < BUCKETS ? duration : BUCKETS - 1]++;
+  result.sum += duration;
+  result.edges++;
+}
+
+void isrNec(void) { measure(resultNec, CNecBench::interrupt); }
+void isrHash(void) { measure(resultHash, CHashIRBench::interrupt); }
+void isrEmpty(void) {}
+
+// Sends a NEC frame and lets the main loop read the data
+template<class T>
+void sendNec(uint8_t pin, T &receiver, Result &result, uint16_t address, uint8_t command)
+{
+  uint32_t bits = address | ((uint32_t)command << 16) |
+                  ((uint32_t)(uint8_t)~command << 24);
+
+  CIRL_Host::mark(pin, NEC_TIMING.markLead);
+  CIRL_Host::space(pin, NEC_TIMING.spaceLead);
+  for (uint8_t i = 0; i < NEC_TIMING.bits; i++) {
+    CIRL_Host::mark(pin, NEC_TIMING.markZero);
+    CIRL_Host::space(pin, (bits & (1UL << i)) ? NEC_TIMING.spaceOne : NEC_TIMING.spaceZero);
+
+    // The main loop polls every bit
+    receiver.available();
+  }
+  CIRL_Host::mark(pin, NEC_TIMING.markZero);
+  CIRL_Host::space(pin, NEC_TIMING.spaceEnd);
+
+  if (receiver.available()) {
+    receiver.read();
+    result.frames++;
+  }
+}
+
+uint32_t percentile(const Result &result, uint8_t percent)
+{
+  uint32_t limit = (uint64_t)result.edges * percent / 100;
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < BUCKETS; i++) {
+    count += result.histogram[i];
+    if (count > limit) {
+      return i;
+    }
+  }
+  return BUCKETS - 1;
+}
+
+#ifdef IRL_PROFILER
+template<class T>
+void printBranches(void)
+{
+  static const char *names[IRL_BRANCH_COUNT] = {
+    "timeout", "lead", "holding", "data", "last", "other"
+  };
+  for (uint8_t i = 0; i < IRL_BRANCH_COUNT; i++) {
+    IRL_Profile_t p = CIRL_Profiler<T>::profile(i);
+    if (p.count) {
+      printf("  %-8s %6u calls  min %4u  max %5u cycles\n",
+             names[i], p.count, p.min, p.max);
+    }
+  }
+}
+#endif
+
+void print(const char *name, const Result &result)
+{
+  printf("%-8s %8lu edges %6lu frames  min %4llu  p50 %4lu  p99 %4lu cycles\n",
+         name, (unsigned long)result.edges, (unsigned long)result.frames,
+         (unsigned long long)result.min,
+         (unsigned long)percentile(result, 50),
+         (unsigned long)percentile(result, 99));
+}
+
+int main(void)
+{
+  CIRL_Host::reset();
+
+  // Calibrate the measuring overhead
+  Result calibration;
+  for (uint16_t i = 0; i < 10000; i++) {
+    measure(calibration, isrEmpty);
+  }
+  overhead = calibration.min;
+
+#ifdef IRL_PROFILER
+  CIRL_Profiler<CNec>::begin();
+  CIRL_Profiler<CHashIR>::begin();
+#endif
+
+  // Attach the measuring interrupts instead of the plain ones
+  pinMode(pinNec, INPUT_PULLUP);
+  pinMode(pinHash, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(pinNec), isrNec, CNecBench::interruptMode);
+  attachInterrupt(digitalPinToInterrupt(pinHash), isrHash, CHashIRBench::interruptMode);
+  CIRL_Host::space(pinNec, 100000UL);
+  CIRL_Host::space(pinHash, 100000UL);
+
+  for (uint16_t i = 0; i < FRAMES; i++) {
+    sendNec(pinNec, nec, resultNec, 0x2222, i);
+    sendNec(pinHash, hash, resultHash, 0x2222, i);
+  }
+
+#ifdef IRL_DEFERRED_DECODE
+  printf("Deferred decoding (IRL_DEFERRED_DECODE %d)\n", IRL_DEFERRED_DECODE);
+#else
+  printf("Decoding inside the interrupt\n");
+#endif
+  print("NEC", resultNec);
+  print("HashIR", resultHash);
+
+#ifdef IRL_PROFILER
+  printf("NEC branches\n");
+  printBranches<CNec>();
+  printf("HashIR branches\n");
+  printBranches<CHashIR>();
+#endif
+  return 0;
+}
@@ -0,0 +1,140 @@
+/*
+  Copyright (c) 2014-2018 NicoHood
+  See the readme for credit to other people.
+
+  IRL Benchmark_Zones
+
+  Runs 8 NEC receivers on 8 pins at the same time. Every zone receives its
+  own frames, shifted in time so the edges of all zones interleave.
+  Checks that no zone corrupts another one and prints the RAM per instance.
+
+  g++ -std=gnu++11 -O2 -I../../src Benchmark_Zones.cpp ../../src/IRLremote.cpp -o Benchmark_Zones
+*/
+
+#include "IRLremote.h"
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+#define ZONES 8
+#define FRAMES 1000
+
+// Exposes the static decoding state to calculate its size
+template<uint8_t instance>
+class CNecZone : public CNecInstance<instance> {
+public:
+  static constexpr size_t ram = sizeof(CNecZone::count) +
+                                sizeof(CNecZone::data) +
+                                sizeof(CNecZone::mlastTime) +
+                                sizeof(CNecZone::mlastEvent)
+#ifdef IRL_DEFERRED_DECODE
+                                + sizeof(CNecZone::mbuffer) +
+                                sizeof(CNecZone::mhead) +
+                                sizeof(CNecZone::mtail) +
+                                sizeof(CNecZone::mcaptureTime)
+#endif
+                                ;
+};
+
+struct Edge {
+  uint32_t time;
+  uint8_t pin;
+  uint8_t level;
+  bool operator<(const Edge &other) const { return time < other.time; }
+};
+
+uint32_t decoded[ZONES] = { 0 };
+uint32_t errors[ZONES] = { 0 };
+
+// Zone n uses pin n and its own instance
+template<uint8_t n>
+struct Zones {
+  static CNecZone<n> receiver;
+
+  static void begin(void) {
+    receiver.begin(n);
+    Zones<n - 1>::begin();
+  }
+
+  static void read(void) {
+    if (receiver.available()) {
+      auto data = receiver.read();
+      if (data.address == n && data.command == (decoded[n] & 0xFF)) {
+        decoded[n]++;
+      }
+      else {
+        errors[n]++;
+      }
+    }
+    Zones<n - 1>::read();
+  }
+
+  static size_t ram(void) {
+    return CNecZone<n>::ram + Zones<n - 1>::ram();
+  }
+};
+
+template<>
+struct Zones<0xFF> {
+  static void begin(void) {}
+  static void read(void) {}
+  static size_t ram(void) { return 0; }
+};
+
+template<uint8_t n> CNecZone<n> Zones<n>::receiver;
+
+// Adds the edges of a NEC frame, address is the zone number
+uint32_t addFrame(std::vector<Edge> &edges, uint32_t time, uint8_t pin, uint8_t command)
+{
+  uint32_t bits = pin | ((uint32_t)command << 16) |
+                  ((uint32_t)(uint8_t)~command << 24);
+
+  edges.push_back({ time, pin, LOW });
+  time += NEC_TIMING.markLead;
+  edges.push_back({ time, pin, HIGH });
+  time += NEC_TIMING.spaceLead;
+  for (uint8_t i = 0; i < NEC_TIMING.bits; i++) {
+    edges.push_back({ time, pin, LOW });
+    time += NEC_TIMING.markZero;
+    edges.push_back({ time, pin, HIGH });
+    time += (bits & (1UL << i)) ? NEC_TIMING.spaceOne : NEC_TIMING.spaceZero;
+  }
+  edges.push_back({ time, pin, LOW });
+  time += NEC_TIMING.markZero;
+  edges.push_back({ time, pin, HIGH });
+  return time + NEC_TIMING.spaceEnd;
+}
+
+int main(void)
+{
+  CIRL_Host::reset();
+  Zones<ZONES - 1>::begin();
+
+  // Shift every zone by a few milliseconds
+  std::vector<Edge> edges;
+  for (uint8_t pin = 0; pin < ZONES; pin++) {
+    uint32_t time = 100000UL + pin * 7919UL;
+    for (uint16_t i = 0; i < FRAMES; i++) {
+      time = addFrame(edges, time, pin, i);
+    }
+  }
+  std::stable_sort(edges.begin(), edges.end());
+
+  for (const Edge &edge : edges) {
+    CIRL_Host::setMicros(edge.time);
+    CIRL_Host::write(edge.pin, edge.level);
+    Zones<ZONES - 1>::read();
+  }
+
+  uint32_t total = 0;
+  for (uint8_t pin = 0; pin < ZONES; pin++) {
+    printf("Zone %u: %lu frames decoded, %lu errors\n", pin,
+           (unsigned long)decoded[pin], (unsigned long)errors[pin]);
+    total += decoded[pin];
+  }
+  printf("%lu of %lu frames decoded\n", (unsigned long)total,
+         (unsigned long)ZONES * FRAMES);
+  printf("RAM per NEC instance: %u bytes, %u zones: %u bytes\n",
+         (unsigned)CNecZone<0>::ram, ZONES, (unsigned)Zones<ZONES - 1>::ram());
+  return total == ZONES * FRAMES ? 0 : 1;
+}
@@ -0,0 +1,491 @@
+/*
+  Copyright (c) 2014-2018 NicoHood
+  See the readme for credit to other people.
+
+  IRL Check_Host
+
+  Regression checks for decoder corner cases on a PC. Every check feeds
+  synthetic edges into a decoder on the virtual clock and compares the
+  result. Prints one line per check and returns 1 if any check failed.
+  Also compile it with -DIRL_DEFERRED_DECODE=128, -DIRL_FRAME_QUEUE=4,
+  -DIRL_GLITCH_FILTER=100 and -DIRL_TIMER_CAPTURE.
+
+  Compile and run on Linux/macOS:
+  g++ -std=gnu++11 -O2 -I../../src Check_Host.cpp ../../src/IRLremote.cpp -o Check_Host
+  ./Check_Host
+*/
+
+#include "IRLremote.h"
+#include "IRL_Batch.h"
+#include "IRL_Convert.h"
+#include <stdio.h>
+
+// Every decoder has its own simulated pin
+#define pinSony 2
+#define pinEvents 3
+#define pinRC5 4
+#define pinRC6 5
+#define pinRC5Events 6
+#define pinSeries 7
+
+// Idle time before every check, long enough to time out all decoders
+#define IDLE 100000UL
+
+CSony sony;
+CIRL_Events<CSonyInstance<1>> events;
+CIRL_Events<CSonyInstance<2>> series;
+CIRL_Events<CRC5Instance<1>> eventsRC5;
+CRC5 rc5;
+CRC6 rc6;
+typedef CIRL_Batch<CNecInstance<1>> BatchNec;
+
+static uint16_t failed = 0;
+
+// Gives the checks access to the HashIR comparison
+struct HashAccess : public CHashIRInstance<1> {
+  using CHashIRInstance<1>::threeQuarters;
+};
+
+static void check(const char *name, bool ok)
+{
+  printf("%-48s %s\n", name, ok ? "ok" : "FAILED");
+  if (!ok) {
+    failed++;
+  }
+}
+
+// Sends a Sony frame with LSB first data, without the space after the
+// last mark. Optionally the mark of a bit is split by a spike.
+static void sendSony(uint32_t bits, uint8_t length, uint8_t pin = pinSony,
+                     uint8_t spikeBit = 0xFF, uint16_t spike = 0)
+{
+  CIRL_Host::mark(pin, SONY_MARK_LEAD);
+  CIRL_Host::space(pin, SONY_SPACE_LEAD);
+  for (uint8_t i = 0; i < length; i++) {
+    if (i) {
+      CIRL_Host::space(pin, SONY_SPACE_ZERO);
+    }
+    uint16_t mark = (bits & (1UL << i)) ? SONY_MARK_ONE : SONY_MARK_ZERO;
+    if (i == spikeBit) {
+      CIRL_Host::mark(pin, mark / 2);
+      CIRL_Host::space(pin, spike);
+      mark -= mark / 2 + spike;
+    }
+    CIRL_Host::mark(pin, mark);
+  }
+}
+
+// Sends the halves of bi-phase bits, MSB first. Halves of the same level are
+// merged, the leading space and the space after the last mark are the idle
+// line. Every half is unit long, the halves of bit doubleBit are twice as long.
+static void sendBiphase(uint32_t bits, uint8_t length, uint16_t unit,
+                        bool markFirst, uint8_t pin, uint8_t doubleBit = 0xFF)
+{
+  bool mark = false;
+  uint16_t duration = 0;
+  for (uint8_t i = 0; i < length * 2; i++) {
+    bool one = bits & (1UL << (length - 1 - i / 2));
+    bool level = (one == markFirst) == !(i % 2);
+    uint16_t half = (i / 2 == doubleBit) ? 2 * unit : unit;
+    if (level != mark && duration) {
+      if (mark) {
+        CIRL_Host::mark(pin, duration);
+      }
+      else {
+        CIRL_Host::space(pin, duration);
+      }
+      duration = 0;
+    }
+    mark = level;
+    duration += half;
+  }
+  if (mark) {
+    CIRL_Host::mark(pin, duration);
+  }
+}
+
+// Sends a RC5 frame: start bit, inverted command bit 6, toggle, address and
+// command
+static void sendRC5(uint8_t address, uint8_t command, uint8_t toggle,
+                    uint8_t pin = pinRC5)
+{
+  uint16_t bits = (1U << 13) | ((~command & 0x40U) << 6) |
+                  ((toggle & 1U) << 11) | ((address & 0x1FU) << 6) |
+                  (command & 0x3FU);
+  sendBiphase(bits, RC5_DATA_LENGTH, RC5_PULSE, false, pin);
+}
+
+// Sends a RC6 frame: lead, start bit, mode, double width toggle, address and
+// command
+static void sendRC6(uint8_t address, uint8_t command, uint8_t toggle,
+                    uint8_t mode = 0, uint8_t pin = pinRC6)
+{
+  uint32_t bits = (1UL << 20) | (uint32_t(mode & 0x07) << 17) |
+                  (uint32_t(toggle & 1) << 16) | (uint32_t(address) << 8) |
+                  command;
+  CIRL_Host::mark(pin, RC6_MARK_LEAD);
+  CIRL_Host::space(pin, RC6_SPACE_LEAD);
+  sendBiphase(bits, RC6_DATA_LENGTH, RC6_PULSE, true, pin, RC6_TOGGLE_BIT);
+}
+
+// Durations of a NEC frame (address 0x1234, command 0x56) after an idle
+// line, for a batch. Optionally the mark of a bit is split by a spike.
+static uint8_t necDurations(uint32_t *durations, uint8_t spikeBit = 0xFF,
+                            uint16_t spike = 0)
+{
+  uint32_t bits = 0x1234UL | (0x56UL << 16) | (uint32_t(0xFF & ~0x56) << 24);
+  uint8_t length = 0;
+  durations[length++] = IDLE;
+  durations[length++] = NEC_TIMING.markLead;
+  durations[length++] = NEC_TIMING.spaceLead;
+  for (uint8_t i = 0; i < 32; i++) {
+    uint16_t mark = NEC_TIMING.markZero;
+    if (i == spikeBit) {
+      durations[length++] = mark / 2;
+      durations[length++] = spike;
+      mark -= mark / 2 + spike;
+    }
+    durations[length++] = mark;
+    durations[length++] = (bits & (1UL << i)) ? NEC_TIMING.spaceOne
+                                              : NEC_TIMING.spaceZero;
+  }
+  durations[length++] = NEC_TIMING.markZero;
+  return length;
+}
+
+// A Sony frame followed by a gap of any length is completed by the next
+// lead, even if available() was not called during the gap
+static void checkSonyGap(uint32_t gap)
+{
+  CIRL_Host::reset();
+  sony.begin(pinSony);
+  CIRL_Host::advance(IDLE);
+
+  sendSony(0x5A5, 12);
+  CIRL_Host::space(pinSony, gap);
+  CIRL_Host::mark(pinSony, SONY_MARK_LEAD);
+
+  bool ok = sony.available();
+  auto data = sony.read();
+  ok = ok && data.length == 12 && data.address == (0x5A5 >> 7) &&
+       data.command == (0x5A5 & 0x7F);
+
+  char name[48];
+  snprintf(name, sizeof(name), "Sony frame, %lu us gap, next lead",
+           (unsigned long)gap);
+  check(name, ok);
+  sony.end(pinSony);
+}
+
+// readTime() belongs to the frame of the last read(), even if lastEvent()
+// was already changed by the next frame. Both are ticks of the timebase.
+static void checkReadTime(void)
+{
+  CIRL_Host::reset();
+  sony.begin(pinSony);
+  CIRL_Host::advance(IDLE);
+
+  sendSony(0x123, 12);
+  uint32_t first = CSony::Timebase::now();
+  CIRL_Host::space(pinSony, IDLE);
+  bool ok = sony.available();
+  sony.read();
+
+  sendSony(0x456, 12);
+  CIRL_Host::space(pinSony, IDLE);
+  ok = ok && sony.available() && sony.readTime() == first &&
+       sony.lastEvent() != first;
+  check("readTime() after the next frame", ok);
+  sony.end(pinSony);
+}
+
+// Another Sony key with the same frame length is a new press
+static void checkSonyEvents(void)
+{
+  CIRL_Host::reset();
+  events.begin(pinEvents);
+  CIRL_Host::advance(IDLE);
+
+  static const uint32_t keys[] = { 0x123, 0x123, 0x124 };
+  uint32_t start = CIRL_Host::micros();
+  for (uint32_t key : keys) {
+    sendSony(key, 12, pinEvents);
+    start += SONY_TIMESPAN_HOLDING;
+    CIRL_Host::space(pinEvents, start - CIRL_Host::micros());
+    events.process();
+  }
+
+  static const IRL_EventType expected[] = {
+    IRL_EVENT_PRESS, IRL_EVENT_HOLD, IRL_EVENT_RELEASE, IRL_EVENT_END,
+    IRL_EVENT_PRESS
+  };
+  IRL_Event_t event;
+  bool ok = true;
+  for (IRL_EventType type : expected) {
+    ok = ok && events.readEvent(event) && event.type == type;
+  }
+  ok = ok && event.command == (0x124 & 0x7F);
+  check("Sony events, other key with the same length", ok);
+  events.end(pinEvents);
+}
+
+// The same Sony data with another length is another button, it ends the
+// press series
+static void checkSonySeries(void)
+{
+  CIRL_Host::reset();
+  series.begin(pinSeries);
+  CIRL_Host::advance(IDLE);
+
+  sendSony(0x123, 12, pinSeries);
+  CIRL_Host::space(pinSeries, SONY_TIMESPAN_HOLDING);
+  series.process();
+  sendSony(0x123, 15, pinSeries);
+  CIRL_Host::space(pinSeries, SONY_TIMESPAN_HOLDING);
+  series.process();
+
+  static const IRL_EventType expected[] = {
+    IRL_EVENT_PRESS, IRL_EVENT_RELEASE, IRL_EVENT_END, IRL_EVENT_PRESS
+  };
+  IRL_Event_t event;
+  bool ok = true;
+  for (IRL_EventType type : expected) {
+    ok = ok && series.readEvent(event) && event.type == type;
+  }
+  ok = ok && event.count == 1;
+  check("Sony events, other length ends the series", ok);
+  series.end(pinSeries);
+}
+
+// A new RC5 press of the same button toggles. It releases the button and
+// continues the press series.
+static void checkRC5Events(void)
+{
+  CIRL_Host::reset();
+  eventsRC5.begin(pinRC5Events);
+  CIRL_Host::advance(IDLE);
+
+  for (uint8_t toggle = 0; toggle < 2; toggle++) {
+    sendRC5(0x15, 0x0A, toggle, pinRC5Events);
+    CIRL_Host::space(pinRC5Events, RC5_TIMESPAN_HOLDING);
+    eventsRC5.process();
+  }
+
+  static const IRL_EventType expected[] = {
+    IRL_EVENT_PRESS, IRL_EVENT_RELEASE, IRL_EVENT_PRESS
+  };
+  IRL_Event_t event;
+  bool ok = true;
+  for (IRL_EventType type : expected) {
+    ok = ok && eventsRC5.readEvent(event) && event.type == type;
+  }
+  ok = ok && event.count == 2;
+  check("RC5 events, toggled press continues the series", ok);
+  eventsRC5.end(pinRC5Events);
+}
+
+// Counts the NEC frames of a batch
+struct NecCounter {
+  uint16_t frames = 0;
+  Nec_data_t data;
+  void operator()(const Nec_data_t &frame, uint64_t) {
+    data = frame;
+    frames++;
+  }
+};
+
+// A batch decodes between the edges of a live receiver without changing its
+// virtual clock
+static void checkBatchLive(void)
+{
+  CIRL_Host::reset();
+  sony.begin(pinSony);
+  CIRL_Host::advance(IDLE);
+
+  // Drop the frames of the last checks
+  while (sony.available()) {
+    sony.read();
+  }
+
+  // The first half of a Sony frame is received live
+  CIRL_Host::mark(pinSony, SONY_MARK_LEAD);
+  CIRL_Host::space(pinSony, SONY_SPACE_LEAD);
+  uint32_t clock = CIRL_Host::micros();
+
+  // A complete NEC frame is decoded in between
+  uint32_t durations[3 + 2 * 32 + 1];
+  uint8_t length = necDurations(durations);
+  NecCounter counter;
+  BatchNec::decode(durations, length, counter);
+  BatchNec::flush(counter);
+  bool ok = counter.frames == 1 && counter.data.address == 0x1234 &&
+            counter.data.command == 0x56 && CIRL_Host::micros() == clock;
+
+  // The live frame continues on the same clock
+  for (uint8_t i = 0; i < 12; i++) {
+    if (i) {
+      CIRL_Host::space(pinSony, SONY_SPACE_ZERO);
+    }
+    CIRL_Host::mark(pinSony, (0x5A5 & (1UL << i)) ? SONY_MARK_ONE
+                                                   : SONY_MARK_ZERO);
+  }
+  CIRL_Host::space(pinSony, IDLE);
+  ok = ok && sony.available();
+  auto data = sony.read();
+  ok = ok && data.length == 12 && data.command == (0x5A5 & 0x7F);
+  check("Batch between the edges of a live receiver", ok);
+  sony.end(pinSony);
+}
+
+#ifdef IRL_GLITCH_FILTER
+// A spike in the middle of a mark is removed. The edges after it keep their
+// level, in a decoder that sees every edge (Sony) and in CIRL_Multi (batch).
+static void checkSpike(void)
+{
+  CIRL_Host::reset();
+  sony.begin(pinSony);
+  CIRL_Host::advance(IDLE);
+  while (sony.available()) {
+    sony.read();
+  }
+
+  sendSony(0x5A5, 12, pinSony, 2, IRL_GLITCH_FILTER / 2);
+  CIRL_Host::space(pinSony, IDLE);
+  bool ok = sony.available();
+  auto data = sony.read();
+  ok = ok && data.length == 12 && data.address == (0x5A5 >> 7) &&
+       data.command == (0x5A5 & 0x7F);
+  check("Sony frame, spike in a mark", ok);
+  sony.end(pinSony);
+
+  uint32_t durations[3 + 2 * 32 + 3];
+  uint8_t length = necDurations(durations, 5, IRL_GLITCH_FILTER / 2);
+  NecCounter counter;
+  BatchNec::decode(durations, length, counter);
+  BatchNec::flush(counter);
+  ok = counter.frames == 1 && counter.data.address == 0x1234 &&
+       counter.data.command == 0x56;
+  check("NEC batch, spike in a mark", ok);
+}
+#endif
+
+// RC5 frames decode with the address, both halves of the command and the
+// toggle bit of every press
+static void checkRC5(void)
+{
+  CIRL_Host::reset();
+  rc5.begin(pinRC5);
+  CIRL_Host::advance(IDLE);
+
+  sendRC5(0x15, 0x0A, 0);
+  CIRL_Host::space(pinRC5, IDLE);
+  bool ok = rc5.available();
+  auto data = rc5.read();
+  ok = ok && data.address == 0x15 && data.command == 0x0A && !data.toggle;
+
+  sendRC5(0x0A, 0x55, 1);
+  CIRL_Host::space(pinRC5, IDLE);
+  ok = ok && rc5.available();
+  data = rc5.read();
+  ok = ok && data.address == 0x0A && data.command == 0x55 && data.toggle;
+  check("RC5 frames with toggle", ok);
+  rc5.end(pinRC5);
+}
+
+// RC6 frames decode with the double width toggle bit of every press. Only
+// mode 0 is accepted.
+static void checkRC6(void)
+{
+  CIRL_Host::reset();
+  rc6.begin(pinRC6);
+  CIRL_Host::advance(IDLE);
+
+  sendRC6(0xA5, 0x3C, 0);
+  CIRL_Host::space(pinRC6, IDLE);
+  bool ok = rc6.available();
+  auto data = rc6.read();
+  ok = ok && data.address == 0xA5 && data.command == 0x3C && !data.toggle;
+
+  sendRC6(0x5A, 0xC3, 1);
+  CIRL_Host::space(pinRC6, IDLE);
+  ok = ok && rc6.available();
+  data = rc6.read();
+  ok = ok && data.address == 0x5A && data.command == 0xC3 && data.toggle;
+  check("RC6 frames with toggle", ok);
+
+  sendRC6(0x5A, 0xC3, 0, 6);
+  CIRL_Host::space(pinRC6, IDLE);
+  check("RC6 frame with mode 6 ignored", !rc6.available());
+  rc6.end(pinRC6);
+}
+
+// The 75% tolerance of HashIR matches the 16 bit unsigned x * 3 / 4 of AVR
+// for every microsecond duration, so learned hashes stay the same, and the
+// exact value for every tick duration.
+static void checkHashCompare(void)
+{
+  bool ok = true;
+  for (uint32_t x = 0; x <= 0xFFFF; x++) {
+    uint16_t avr = uint16_t(x * 3) / 4;
+    uint16_t value = HashAccess::threeQuarters(x);
+    if (x < HASHIR_TIMEOUT && value != avr) {
+      ok = false;
+    }
+    if (value != x * 3 / 4) {
+      ok = false;
+    }
+  }
+  check("HashIR compare", ok);
+}
+
+
+// The text sizes fit the written text of every encoded protocol, Pronto
+// exactly. length is the number of durations, repeatLength of the Pronto
+// repeat sequence.
+template<class Protocol_data_t>
+static void checkTextSize(const char *name, const Protocol_data_t &data,
+                          const Protocol_data_t &repeat)
+{
+  uint16_t durations[IRL_CONVERT_LENGTH];
+  uint32_t gap;
+  uint8_t length = CIRL_Convert::encode(data, durations, gap);
+  uint8_t repeatLength = CIRL_Convert::encode(repeat, durations, gap);
+
+  static char text[IRL_CONVERT_TEXT];
+  size_t pronto = IRL_PRONTO_TEXT(length, repeatLength);
+  size_t mode2 = IRL_MODE2_TEXT(length);
+  size_t size = CIRL_Convert::writePronto(data, text);
+  bool ok = size == strlen(text) && strlen(text) < pronto &&
+            strlen(text) + 1 == pronto;
+  size = CIRL_Convert::writeMode2(data, text);
+  ok = ok && size == strlen(text) && strlen(text) < mode2;
+  check(name, ok);
+}
+
+int main(void)
+{
+  checkSonyGap(30000);
+  checkSonyGap(SONY_TIMESPAN_HOLDING + 5000);
+  checkSonyGap(200000);
+  checkReadTime();
+  checkSonyEvents();
+  checkSonySeries();
+  checkBatchLive();
+#ifdef IRL_GLITCH_FILTER
+  checkSpike();
+#endif
+  checkRC5();
+  checkRC6();
+  checkRC5Events();
+  checkHashCompare();
+  checkTextSize("NEC text size", Nec_data_t{ 0x1234, 0xFF },
+                Nec_data_t{ 0xFFFF, 0x00 });
+  checkTextSize("NEC holding text size", Nec_data_t{ 0xFFFF, 0x00 },
+                Nec_data_t{ 0xFFFF, 0x00 });
+  checkTextSize("Panasonic text size",
+                Panasonic_data_t{ 0xFFFF, 0xFFFFFFFF },
+                Panasonic_data_t{ 0xFFFF, 0xFFFFFFFF });
+
+  printf("%u failed\n", failed);
+  return failed ? 1 : 0;
+}
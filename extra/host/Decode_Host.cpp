@@ -0,0 +1,313 @@
+/*
+  Copyright (c) 2014-2018 NicoHood
+  See the readme for credit to other people.
+
+  IRL Decode_Host (irl-decode)
+
+  Decodes recorded IR traffic offline with the NEC, Panasonic and HashIR
+  decoders and prints every frame with its timestamp (seconds since the start
+  of the first file). The edges are decoded with CIRL_Batch (src/IRL_Batch.h),
+  without simulated pins and interrupts. The files are memory mapped,
+  so recordings of several days can be decoded.
+
+  Supported files, detected by their content:
+  - IRL captures (see src/IRL_Capture.h)
+  - Pronto hex codes, one per line ("0000 006D 0022 0002 0157 ...")
+  - LIRC mode2 text ("pulse 560", "space 1690", "timeout 20000")
+  The text formats are parsed with src/IRL_Convert.h.
+
+  Compile and run on Linux/macOS:
+  g++ -std=gnu++11 -O2 -I../../src Decode_Host.cpp ../../src/IRLremote.cpp -o irl-decode
+
+  Print all frames, -q only prints the summary with the decoding speed,
+  -p and -m print the NEC and Panasonic frames as Pronto or mode2 instead:
+  ./irl-decode [-q|-p|-m] capture.irlc [more.irlc ...]
+  mode2 -d /dev/lirc0 > traffic.txt; ./irl-decode traffic.txt
+*/
+
+#include "IRLremote.h"
+#include "IRL_Capture.h"
+#include "IRL_Batch.h"
+#include "IRL_Convert.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// The tool has no receivers, the default instances decode offline
+typedef CIRL_Batch<CNec, CPanasonic, CHashIR> CDecoder;
+
+// Durations are decoded in blocks
+#define BLOCK 4096
+
+//==============================================================================
+// Frame output
+//==============================================================================
+
+struct Output {
+  bool quiet = false;
+  char format = 0;
+  uint64_t nec = 0;
+  uint64_t panasonic = 0;
+  uint64_t hash = 0;
+
+  void time(uint64_t time) {
+    printf("%llu.%06llu ", (unsigned long long)(time / 1000000ULL),
+           (unsigned long long)(time % 1000000ULL));
+  }
+
+  // Prints the frame as Pronto or mode2 text
+  template<class Protocol_data_t>
+  bool convert(const Protocol_data_t &data) {
+    static char text[IRL_CONVERT_TEXT];
+    if (format == 'p') {
+      CIRL_Convert::writePronto(data, text);
+      puts(text);
+    }
+    else if (format == 'm') {
+      CIRL_Convert::writeMode2(data, text);
+      fputs(text, stdout);
+    }
+    return format;
+  }
+
+  void operator()(const Nec_data_t &data, uint64_t t) {
+    nec++;
+    if (!quiet && !convert(data)) {
+      time(t);
+      printf("NEC       Address: 0x%04X Command: 0x%02X\n",
+             data.address, data.command);
+    }
+  }
+
+  void operator()(const Panasonic_data_t &data, uint64_t t) {
+    panasonic++;
+    if (!quiet && !convert(data)) {
+      time(t);
+      printf("Panasonic Address: 0x%04X Command: 0x%08lX\n",
+             data.address, (unsigned long)data.command);
+    }
+  }
+
+  void operator()(const HashIR_data_t &data, uint64_t t) {
+    hash++;
+    if (!quiet && !format) {
+      time(t);
+      printf("HashIR    Hash: 0x%08lX Length: %u\n",
+             (unsigned long)data.command, data.address);
+    }
+  }
+};
+
+//==============================================================================
+// Input formats
+//==============================================================================
+
+// Decodes an IRL capture, returns the number of edges
+static uint64_t decodeCapture(const uint8_t *buffer, const uint8_t *end,
+                              Output &output)
+{
+  IRL_CaptureHeader_t header;
+  if (!CIRL_Capture::readHeader(buffer, end - buffer, header)) {
+    return 0;
+  }
+  buffer += IRL_CAPTURE_HEADER_LENGTH;
+
+  // The idle level is decoded as long space in front of the first edge
+  uint32_t durations[BLOCK];
+  uint64_t edges = 0;
+  while (buffer < end && (!header.edges || edges < header.edges))
+  {
+    size_t length = 0;
+    while (length < BLOCK && buffer < end &&
+           (!header.edges || edges + length < header.edges))
+    {
+      // Most durations take one or two bytes
+      uint32_t duration = buffer[0];
+      if (duration < 0x80) {
+        buffer++;
+      }
+      else if (buffer + 1 < end && buffer[1] < 0x80) {
+        duration = (duration & 0x7F) | (uint32_t(buffer[1]) << 7);
+        buffer += 2;
+      }
+      else
+      {
+        uint8_t read = CIRL_Capture::readDuration(buffer, end, duration);
+        if (!read) {
+          fprintf(stderr, "truncated after %llu edges\n",
+                  (unsigned long long)(edges + length));
+          buffer = end;
+          break;
+        }
+        buffer += read;
+      }
+      durations[length++] = duration;
+    }
+    CDecoder::decode(durations, length, output);
+    edges += length;
+  }
+  return edges;
+}
+
+
+// Passes the durations of parsed text to the decoders in blocks
+struct Durations {
+  Output &output;
+  uint32_t durations[BLOCK];
+  size_t length = 0;
+  uint64_t edges = 0;
+
+  Durations(Output &output) : output(output) {}
+
+  void operator()(uint32_t duration) {
+    durations[length++] = duration;
+    if (length == BLOCK) {
+      flush();
+    }
+  }
+
+  void flush(void) {
+    CDecoder::decode(durations, length, output);
+    edges += length;
+    length = 0;
+  }
+};
+
+
+// Decodes Pronto or mode2 text, returns the number of edges
+template<class Parser>
+static uint64_t decodeText(const char *text, const char *end, Parser &parser,
+                           Output &output)
+{
+  Durations durations(output);
+  CIRL_Edges<Durations> edges(durations);
+  parser.parse(text, end - text, edges);
+  parser.finish(edges);
+  edges.finish();
+  durations.flush();
+  return durations.edges;
+}
+
+
+// Pronto files start with a learned code
+static bool isPronto(const char *text, const char *end)
+{
+  while (text < end && (*text == ' ' || *text == '\r' || *text == '\n')) {
+    text++;
+  }
+  return end - text >= 5 && !memcmp(text, "0000 ", 5);
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+static bool decodeFile(const char *path, Output &output, uint64_t &edges,
+                       uint64_t &bytes)
+{
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    perror(path);
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) < 0 || st.st_size == 0) {
+    fprintf(stderr, "%s: empty file\n", path);
+    close(fd);
+    return false;
+  }
+  size_t length = st.st_size;
+  void *map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    perror(path);
+    return false;
+  }
+  madvise(map, length, MADV_SEQUENTIAL);
+
+  const uint8_t *buffer = (const uint8_t *)map;
+  bool ok = true;
+  if (length >= 4 && !memcmp(buffer, "IRLC", 4))
+  {
+    uint64_t count = decodeCapture(buffer, buffer + length, output);
+    if (!count) {
+      fprintf(stderr, "%s: not a valid capture\n", path);
+      ok = false;
+    }
+    edges += count;
+  }
+  else if (isPronto((const char *)buffer, (const char *)buffer + length))
+  {
+    CIRL_ProntoParser parser;
+    edges += decodeText((const char *)buffer, (const char *)buffer + length,
+                        parser, output);
+    if (parser.errors()) {
+      fprintf(stderr, "%s: %u invalid Pronto codes\n", path, parser.errors());
+    }
+  }
+  else {
+    CIRL_Mode2Parser parser;
+    edges += decodeText((const char *)buffer, (const char *)buffer + length,
+                        parser, output);
+  }
+
+  // Let the last frame time out
+  CDecoder::flush(output);
+  bytes += length;
+
+  munmap(map, length);
+  return ok;
+}
+
+
+int main(int argc, char **argv)
+{
+  Output output;
+  int first = 1;
+  if (argc > 1 && !strcmp(argv[1], "-q")) {
+    output.quiet = true;
+    first++;
+  }
+  else if (argc > 1 && (!strcmp(argv[1], "-p") || !strcmp(argv[1], "-m"))) {
+    output.format = argv[1][1];
+    first++;
+  }
+  if (first >= argc) {
+    fprintf(stderr, "Usage: %s [-q|-p|-m] capture.irlc|pronto.txt|mode2.txt [...]\n",
+            argv[0]);
+    return 1;
+  }
+
+  // Frames are printed in large blocks
+  static char stdoutBuffer[1 << 20];
+  setvbuf(stdout, stdoutBuffer, _IOFBF, sizeof(stdoutBuffer));
+
+  timespec start, stop;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  uint64_t edges = 0;
+  uint64_t bytes = 0;
+  bool ok = true;
+  for (int i = first; i < argc; i++) {
+    ok &= decodeFile(argv[i], output, edges, bytes);
+  }
+  fflush(stdout);
+
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  double seconds = (stop.tv_sec - start.tv_sec) +
+                   (stop.tv_nsec - start.tv_nsec) / 1e9;
+
+  fprintf(stderr, "%llu edges, NEC %llu, Panasonic %llu, HashIR %llu frames\n",
+          (unsigned long long)edges, (unsigned long long)output.nec,
+          (unsigned long long)output.panasonic,
+          (unsigned long long)output.hash);
+  if (seconds > 0) {
+    fprintf(stderr, "%.0f edges/s, %.1f MB/s\n", edges / seconds,
+            bytes / seconds / 1e6);
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,208 @@
+/*
+  Copyright (c) 2014-2018 NicoHood
+  See the readme for credit to other people.
+
+  IRL HashTable_Gen
+
+  Generates a CIRL_HashTable header with learned HashIR codes in PROGMEM.
+  The input has one code per line: the hash, the action number and an
+  optional name for a comment. Empty lines and lines with # are ignored.
+
+    0x2EAD5A33 1 power
+    0xE3A4F71D 2 volume_up
+
+  By default a minimal perfect hash table is generated (constant time lookup).
+  With -s a sorted table for a binary search is generated instead.
+
+  Compile and run on Linux/macOS:
+  g++ -std=gnu++11 -O2 -I../../src HashTable_Gen.cpp -o HashTable_Gen
+  ./HashTable_Gen [-s] remote codes.txt > Remote_Codes.h
+*/
+
+#include "IRL_Platform.h"
+#include "IRL_HashTable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+struct Code {
+  uint32_t hash;
+  uint16_t action;
+  std::string name;
+};
+
+bool parse(const char *path, std::vector<Code> &codes)
+{
+  FILE *file = fopen(path, "r");
+  if (!file) {
+    perror(path);
+    return false;
+  }
+
+  char line[256];
+  unsigned number = 0;
+  while (fgets(line, sizeof(line), file))
+  {
+    number++;
+    char *comment = strchr(line, '#');
+    if (comment) {
+      *comment = '\0';
+    }
+
+    char name[128] = "";
+    unsigned long hash, action;
+    int fields = sscanf(line, "%lx %lu %127s", &hash, &action, name);
+    if (fields <= 0) {
+      continue;
+    }
+    if (fields < 2 || action >= IRL_HASHTABLE_NONE) {
+      fprintf(stderr, "%s:%u: expected <hash> <action 0-65534> [name]\n",
+              path, number);
+      fclose(file);
+      return false;
+    }
+    codes.push_back({ (uint32_t)hash, (uint16_t)action, name });
+  }
+  fclose(file);
+
+  std::sort(codes.begin(), codes.end(),
+            [](const Code &a, const Code &b) { return a.hash < b.hash; });
+  for (size_t i = 1; i < codes.size(); i++) {
+    if (codes[i].hash == codes[i - 1].hash) {
+      fprintf(stderr, "%s: duplicate hash 0x%08lX\n",
+              path, (unsigned long)codes[i].hash);
+      return false;
+    }
+  }
+  return true;
+}
+
+// Hash and displace: the largest buckets get a seed first, every seed moves
+// all codes of its bucket into free slots. Returns false if a bucket fails.
+bool build(const std::vector<Code> &codes, uint16_t buckets,
+           std::vector<uint16_t> &seeds, std::vector<int> &slots)
+{
+  uint16_t length = codes.size();
+  std::vector<std::vector<int>> members(buckets);
+  for (size_t i = 0; i < codes.size(); i++) {
+    members[CIRL_HashTable::slot(CIRL_HashTable::mix(codes[i].hash, 0), buckets)].push_back(i);
+  }
+
+  std::vector<int> order(buckets);
+  for (int i = 0; i < buckets; i++) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return members[a].size() > members[b].size();
+  });
+
+  seeds.assign(buckets, 0);
+  slots.assign(length, -1);
+  for (int bucket : order)
+  {
+    if (members[bucket].empty()) {
+      break;
+    }
+
+    bool found = false;
+    for (uint32_t seed = 1; seed <= 0xFFFF && !found; seed++)
+    {
+      std::vector<uint16_t> used;
+      found = true;
+      for (int code : members[bucket]) {
+        uint16_t s = CIRL_HashTable::slot(CIRL_HashTable::mix(codes[code].hash, seed), length);
+        if (slots[s] >= 0 || std::find(used.begin(), used.end(), s) != used.end()) {
+          found = false;
+          break;
+        }
+        used.push_back(s);
+      }
+      if (found) {
+        for (size_t i = 0; i < used.size(); i++) {
+          slots[used[i]] = members[bucket][i];
+        }
+        seeds[bucket] = seed;
+      }
+    }
+    if (!found) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void print(const Code &code, bool last)
+{
+  printf("    { 0x%08lX, %5u }%s", (unsigned long)code.hash, code.action,
+         last ? " " : ",");
+  if (!code.name.empty()) {
+    printf(" // %s", code.name.c_str());
+  }
+  printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+  bool sorted = argc == 4 && !strcmp(argv[1], "-s");
+  if (argc != (sorted ? 4 : 3)) {
+    fprintf(stderr, "Usage: %s [-s] name codes.txt > header.h\n", argv[0]);
+    return 1;
+  }
+  const char *name = argv[argc - 2];
+
+  std::vector<Code> codes;
+  if (!parse(argv[argc - 1], codes)) {
+    return 1;
+  }
+  if (codes.empty() || codes.size() >= 0xFFFF) {
+    fprintf(stderr, "%s: %zu codes, expected 1-65534\n", argv[argc - 1], codes.size());
+    return 1;
+  }
+
+  std::vector<uint16_t> seeds;
+  std::vector<int> slots;
+  uint16_t buckets = 0;
+  if (!sorted)
+  {
+    // Start with about 4 codes per bucket, use more buckets if it fails
+    for (buckets = (codes.size() + 3) / 4; buckets <= codes.size(); buckets++) {
+      if (build(codes, buckets, seeds, slots)) {
+        break;
+      }
+    }
+    if (buckets > codes.size()) {
+      fprintf(stderr, "No perfect hash found, use a sorted table (-s).\n");
+      return 1;
+    }
+  }
+
+  printf("// Generated by HashTable_Gen from %s, do not edit.\n", argv[argc - 1]);
+  printf("// %zu codes, %s.\n\n", codes.size(), sorted ?
+         "sorted table (binary search)" : "perfect hash table (constant time)");
+  printf("#pragma once\n\n#include \"IRL_HashTable.h\"\n\n");
+
+  printf("static constexpr IRL_HashCode_t %s_codes[] PROGMEM = {\n", name);
+  for (size_t i = 0; i < codes.size(); i++) {
+    print(codes[sorted ? i : slots[i]], i + 1 == codes.size());
+  }
+  printf("};\n\n");
+
+  if (sorted) {
+    printf("static_assert(CIRL_HashTable::sorted(%s_codes, %zu), \"Codes not sorted\");\n\n",
+           name, codes.size());
+    printf("static constexpr CIRL_HashTable %s(%s_codes, %zu);\n", name, name, codes.size());
+    return 0;
+  }
+
+  printf("static constexpr uint16_t %s_seeds[] PROGMEM = {", name);
+  for (size_t i = 0; i < seeds.size(); i++) {
+    printf("%s%5u%s", i % 10 ? " " : "\n    ", seeds[i], i + 1 == seeds.size() ? "" : ",");
+  }
+  printf("\n};\n\n");
+  printf("static constexpr CIRL_HashTable %s(%s_codes, %zu, %s_seeds, %u);\n",
+         name, name, codes.size(), name, buckets);
+  return 0;
+}
@@ -0,0 +1,367 @@
+/*
+  Copyright (c) 2014-2018 NicoHood
+  See the readme for credit to other people.
+
+  IRL Keymap_Gen
+
+  Generates keycode tables for src/IRL_Keycodes.h from LIRC remote
+  definitions (lircd.conf). Every remote gets a namespace with its address,
+  the raw commands (IRL_Keycode) and the unified keys (IRL_KEYS), like the
+  existing remotes. Add the IRL_KEYMAP of each remote to IRL_KEYMAPS.
+
+  Supported protocols: NEC (32 bit, with inverted command), Sony 12/15/20,
+  RC5 and RC6 mode 0. Button names of the Linux input layer (KEY_POWER,
+  KEY_VOLUMEUP, ...) are mapped to the unified IRL_Key, other buttons are
+  only added to IRL_Keycode.
+
+  Compile and run on Linux/macOS:
+  g++ -std=gnu++11 -O2 Keymap_Gen.cpp -o Keymap_Gen
+  ./Keymap_Gen remote.lircd.conf > Remote_Keycodes.h
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <string>
+#include <vector>
+
+struct Button {
+  std::string name;
+  uint8_t command;
+};
+
+struct Remote {
+  std::string name;
+  std::string flags;
+  unsigned bits = 0;
+  unsigned preDataBits = 0;
+  unsigned postDataBits = 0;
+  uint64_t preData = 0;
+  uint64_t postData = 0;
+  uint64_t toggleMask = 0;
+  unsigned headerMark = 0;
+  std::vector<std::pair<std::string, uint64_t>> codes;
+
+  // Decoded values
+  const char *protocol = nullptr;
+  const char *type = nullptr;
+  uint16_t address = 0;
+  std::vector<Button> buttons;
+};
+
+// Linux input names and the unified IRL_Key
+static const char *const keys[][2] = {
+  { "KEY_POWER", "POWER" }, { "KEY_MUTE", "MUTE" },
+  { "KEY_SCREEN", "SCREEN" }, { "KEY_SAT", "SATELLITE" },
+  { "KEY_RADIO", "TV_RADIO" }, { "KEY_AUDIO", "TV_MUSIC" },
+  { "KEY_TV", "TV" }, { "KEY_SWITCHVIDEOMODE", "SOURCE" },
+  { "KEY_1", "1" }, { "KEY_2", "2" }, { "KEY_3", "3" }, { "KEY_4", "4" },
+  { "KEY_5", "5" }, { "KEY_6", "6" }, { "KEY_7", "7" }, { "KEY_8", "8" },
+  { "KEY_9", "9" }, { "KEY_0", "0" }, { "KEY_BACK", "BACK" },
+  { "KEY_FAVORITES", "FAVORITE" },
+  { "KEY_VOLUMEUP", "VOL_UP" }, { "KEY_VOLUMEDOWN", "VOL_DOWN" },
+  { "KEY_EPG", "EPG" }, { "KEY_INFO", "INFO" },
+  { "KEY_CHANNELUP", "CHANNEL_UP" }, { "KEY_CHANNELDOWN", "CHANNEL_DOWN" },
+  { "KEY_UP", "UP" }, { "KEY_DOWN", "DOWN" }, { "KEY_LEFT", "LEFT" },
+  { "KEY_RIGHT", "RIGHT" }, { "KEY_OK", "OK" }, { "KEY_ENTER", "OK" },
+  { "KEY_SELECT", "OK" }, { "KEY_EXIT", "EXIT" }, { "KEY_MENU", "MENU" },
+  { "KEY_LANGUAGE", "I_II" }, { "KEY_TEXT", "TELETEXT" },
+  { "KEY_SUBTITLE", "SUBTITLE" },
+  { "KEY_RED", "RED" }, { "KEY_GREEN", "GREEN" }, { "KEY_YELLOW", "YELLOW" },
+  { "KEY_BLUE", "BLUE" },
+  { "KEY_PREVIOUS", "PREV" }, { "KEY_PREVIOUSSONG", "PREV" },
+  { "KEY_PLAY", "PLAY" }, { "KEY_STOP", "STOP" }, { "KEY_NEXT", "NEXT" },
+  { "KEY_NEXTSONG", "NEXT" }, { "KEY_PAUSE", "PAUSE" },
+  { "KEY_RECORD", "REC" }, { "KEY_REWIND", "REWIND" },
+  { "KEY_FASTFORWARD", "FORWARD" },
+};
+
+static const char *unified(const std::string &name)
+{
+  for (auto &key : keys) {
+    if (!strcasecmp(name.c_str(), key[0])) {
+      return key[1];
+    }
+  }
+  return nullptr;
+}
+
+// C identifier of a LIRC name: KEY_VOLUMEUP -> VOLUMEUP, 3D-Mode -> 3D_MODE.
+// Remote names keep their case: Protek-9700 -> Protek_9700
+static std::string identifier(std::string name, bool button)
+{
+  if (button && !strncasecmp(name.c_str(), "KEY_", 4)) {
+    name = name.substr(4);
+  }
+  for (char &c : name) {
+    c = isalnum((unsigned char)c) ? c : '_';
+    if (button) {
+      c = toupper((unsigned char)c);
+    }
+  }
+  return name;
+}
+
+static uint64_t reverse(uint64_t value, unsigned bits)
+{
+  uint64_t result = 0;
+  for (unsigned i = 0; i < bits; i++) {
+    result = (result << 1) | ((value >> i) & 1);
+  }
+  return result;
+}
+
+//==============================================================================
+// LIRC Parser
+//==============================================================================
+
+bool parse(const char *path, std::vector<Remote> &remotes)
+{
+  FILE *file = fopen(path, "r");
+  if (!file) {
+    perror(path);
+    return false;
+  }
+
+  enum { OUTSIDE, REMOTE, CODES, RAW } state = OUTSIDE;
+  char line[512];
+  while (fgets(line, sizeof(line), file))
+  {
+    char *comment = strchr(line, '#');
+    if (comment) {
+      *comment = '\0';
+    }
+    char key[128], value[256] = "", value2[256] = "";
+    int fields = sscanf(line, "%127s %255s %255s", key, value, value2);
+    if (fields <= 0) {
+      continue;
+    }
+
+    std::string k = key, v = value;
+    if (k == "begin" && v == "remote") {
+      remotes.push_back(Remote());
+      state = REMOTE;
+    }
+    else if (k == "end" && v == "remote") {
+      state = OUTSIDE;
+    }
+    else if (state == OUTSIDE) {
+      continue;
+    }
+    else if (k == "begin" && v == "codes") {
+      state = CODES;
+    }
+    else if (k == "begin" && v == "raw_codes") {
+      state = RAW;
+    }
+    else if (k == "end") {
+      state = REMOTE;
+    }
+    else if (state == CODES && fields >= 2) {
+      remotes.back().codes.push_back({ k, strtoull(value, NULL, 0) });
+    }
+    else if (state == RAW) {
+      remotes.back().flags += "|RAW_CODES";
+    }
+    else if (state == REMOTE)
+    {
+      Remote &remote = remotes.back();
+      if (k == "name") remote.name = v;
+      else if (k == "flags") remote.flags = v;
+      else if (k == "bits") remote.bits = strtoul(value, NULL, 0);
+      else if (k == "pre_data_bits") remote.preDataBits = strtoul(value, NULL, 0);
+      else if (k == "pre_data") remote.preData = strtoull(value, NULL, 0);
+      else if (k == "post_data_bits") remote.postDataBits = strtoul(value, NULL, 0);
+      else if (k == "post_data") remote.postData = strtoull(value, NULL, 0);
+      else if (k == "toggle_bit_mask") remote.toggleMask = strtoull(value, NULL, 0);
+      else if (k == "header") remote.headerMark = strtoul(value, NULL, 0);
+    }
+  }
+  fclose(file);
+  return true;
+}
+
+//==============================================================================
+// Protocol Conversion
+//==============================================================================
+
+// Converts the LIRC codes (bits in the sent order) to address and command
+// like the read() function of the decoder. Returns an error message.
+const char *convert(Remote &remote)
+{
+  unsigned bits = remote.preDataBits + remote.bits + remote.postDataBits;
+  bool rc5 = remote.flags.find("RC5") != std::string::npos;
+  bool rc6 = remote.flags.find("RC6") != std::string::npos;
+  if (remote.flags.find("RAW_CODES") != std::string::npos) {
+    return "raw codes are not supported, use HashIR";
+  }
+  if (bits > 64) {
+    return "more than 64 bits";
+  }
+
+  for (auto &code : remote.codes)
+  {
+    uint64_t value = (remote.preData << remote.bits) | code.second;
+    value = (value << remote.postDataBits) | remote.postData;
+    value &= ~remote.toggleMask;
+
+    uint16_t address;
+    uint8_t command;
+    if (rc5 && (bits == 13 || bits == 14))
+    {
+      // S2 T A4..A0 C5..C0, the inverted field bit S2 is command bit 6
+      remote.protocol = "IRL_CAPTURE_PROTOCOL_RC5";
+      remote.type = "RC5";
+      address = (value >> 6) & 0x1F;
+      command = (value & 0x3F) | ((~value >> 6) & 0x40);
+    }
+    else if (rc6 && bits == 21)
+    {
+      // Start, mode 0, toggle, 8 bit address, 8 bit command
+      remote.protocol = "IRL_CAPTURE_PROTOCOL_RC6";
+      remote.type = "RC6";
+      if ((value >> 17) & 0x07) {
+        return "only RC6 mode 0 is supported";
+      }
+      address = (value >> 8) & 0xFF;
+      command = value & 0xFF;
+    }
+    else if (rc5 || rc6) {
+      return "unexpected number of bits for RC5/RC6";
+    }
+    else if (remote.headerMark > 8000 && remote.headerMark < 10000 && bits == 32)
+    {
+      // Every byte is sent LSB first
+      remote.protocol = "IRL_CAPTURE_PROTOCOL_NEC";
+      remote.type = "Nec";
+      uint8_t data[4];
+      for (uint8_t i = 0; i < 4; i++) {
+        data[i] = reverse(value >> (24 - 8 * i), 8);
+      }
+      if ((uint8_t)~data[3] != data[2]) {
+        fprintf(stderr, "%s: %s has no inverted command, skipped\n",
+                remote.name.c_str(), code.first.c_str());
+        continue;
+      }
+      address = ((uint16_t)data[1] << 8) | data[0];
+      command = data[2];
+    }
+    else if (remote.headerMark > 2000 && remote.headerMark < 2800 &&
+             (bits == 12 || bits == 15 || bits == 20))
+    {
+      // 7 bit command and the address, LSB first
+      remote.protocol = "IRL_CAPTURE_PROTOCOL_SONY";
+      remote.type = "Sony";
+      value = reverse(value, bits);
+      address = value >> 7;
+      command = value & 0x7F;
+    }
+    else {
+      return "unknown protocol (NEC, Sony, RC5 and RC6 are supported)";
+    }
+
+    if (!remote.buttons.empty() && address != remote.address) {
+      return "buttons with different addresses, split the remote";
+    }
+    remote.address = address;
+    remote.buttons.push_back({ code.first, command });
+  }
+
+  if (remote.buttons.empty()) {
+    return "no codes";
+  }
+  return nullptr;
+}
+
+//==============================================================================
+// Output
+//==============================================================================
+
+void print(const Remote &remote)
+{
+  std::string name = identifier(remote.name, false);
+  printf("//==============================================================================\n");
+  printf("// %s\n", remote.name.c_str());
+  printf("//==============================================================================\n\n");
+  printf("namespace IRL_%s_Remote{\n\n", name.c_str());
+  printf("    // Protocol: %s\n", remote.protocol + strlen("IRL_CAPTURE_PROTOCOL_"));
+  printf("    typedef %s_address_t IRL_address_t;\n", remote.type);
+  printf("    typedef %s_command_t IRL_command_t;\n", remote.type);
+  printf("    typedef %s_data_t IRL_data_t;\n", remote.type);
+  printf("    static const uint16_t IRL_ADDRESS = 0x%04X;\n\n", remote.address);
+
+  printf("    enum IRL_Keycode : uint8_t\n    {\n");
+  std::vector<std::string> written;
+  for (auto &button : remote.buttons) {
+    std::string id = identifier(button.name, true);
+    bool duplicate = false;
+    for (auto &w : written) {
+      duplicate |= w == id;
+    }
+    if (duplicate) {
+      continue;
+    }
+    written.push_back(id);
+    printf("        IRL_KEYCODE_%-20s= 0x%02X,\n", id.c_str(), button.command);
+  }
+  printf("    };\n\n");
+
+  printf("    // Unified keys of the remote\n");
+  printf("    static constexpr IRL_KeyCode_t IRL_KEYS[] = {\n");
+  std::vector<uint8_t> commands;
+  for (auto &button : remote.buttons)
+  {
+    const char *key = unified(button.name);
+    bool duplicate = false;
+    for (uint8_t c : commands) {
+      duplicate |= c == button.command;
+    }
+    if (!key || duplicate) {
+      continue;
+    }
+    commands.push_back(button.command);
+    std::string id = "IRL_KEYCODE_" + identifier(button.name, true) + ",";
+    printf("        { %-25s IRL_KEY_%s },\n", id.c_str(), key);
+  }
+  printf("    };\n");
+  printf("    typedef CIRL_KeymapTable<IRL_KEYS, sizeof(IRL_KEYS) / sizeof(IRL_KEYS[0])> IRL_KEYMAP_TABLE;\n");
+  printf("    static constexpr IRL_Keymap_t IRL_KEYMAP = {\n");
+  printf("        %s, IRL_ADDRESS, IRL_KEYMAP_TABLE::length, IRL_KEYMAP_TABLE::keys\n",
+         remote.protocol);
+  printf("    };\n}\n\n");
+
+  if (commands.empty()) {
+    fprintf(stderr, "%s: no button with a unified key\n", remote.name.c_str());
+  }
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s remote.lircd.conf [...] > keycodes.h\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<Remote> remotes;
+  for (int i = 1; i < argc; i++) {
+    if (!parse(argv[i], remotes)) {
+      return 1;
+    }
+  }
+
+  printf("// Generated by Keymap_Gen, add the IRL_KEYMAP of every remote to\n");
+  printf("// IRL_KEYMAPS in IRL_Keycodes.h (sorted by protocol and address).\n\n");
+  int result = 0;
+  for (auto &remote : remotes)
+  {
+    const char *error = convert(remote);
+    if (error) {
+      fprintf(stderr, "%s: %s\n", remote.name.c_str(), error);
+      result = 1;
+      continue;
+    }
+    print(remote);
+  }
+  return result;
+}
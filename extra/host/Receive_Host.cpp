@@ -0,0 +1,80 @@
+/*
+  Copyright (c) 2014-2018 NicoHood
+  See the readme for credit to other people.
+
+  IRL Receive_Host
+
+  Runs the decoders on a PC with a virtual clock instead of a real receiver.
+  A synthetic NEC frame and a repeat frame are fed into the pin interrupt
+  and the decoded data is printed to stdout.
+
+  Compile and run on Linux/macOS:
+  g++ -std=gnu++11 -O2 -I../../src Receive_Host.cpp ../../src/IRLremote.cpp -o Receive_Host
+  ./Receive_Host
+*/
+
+#include "IRLremote.h"
+#include <stdio.h>
+
+// Any simulated pin is a valid PinInterrupt pin
+#define pinIR 2
+
+CNec IRLremote;
+
+// Sends a NEC frame with LSB first data, followed by its end mark.
+// The trailing space is left to the caller, to read the data in between.
+void sendNec(uint16_t address, uint8_t command)
+{
+  uint32_t bits = address | ((uint32_t)command << 16) |
+                  ((uint32_t)(uint8_t)~command << 24);
+
+  CIRL_Host::mark(pinIR, NEC_TIMING.markLead);
+  CIRL_Host::space(pinIR, NEC_TIMING.spaceLead);
+  for (uint8_t i = 0; i < NEC_TIMING.bits; i++) {
+    CIRL_Host::mark(pinIR, NEC_TIMING.markZero);
+    CIRL_Host::space(pinIR, (bits & (1UL << i)) ? NEC_TIMING.spaceOne : NEC_TIMING.spaceZero);
+  }
+  CIRL_Host::mark(pinIR, NEC_TIMING.markZero);
+}
+
+// Sends a NEC holding frame
+void sendNecHolding(void)
+{
+  CIRL_Host::mark(pinIR, NEC_TIMING.markHolding);
+  CIRL_Host::space(pinIR, NEC_TIMING.spaceHolding);
+  CIRL_Host::mark(pinIR, NEC_TIMING.markZero);
+}
+
+void print(void)
+{
+  if (IRLremote.available())
+  {
+    auto data = IRLremote.read();
+    printf("%10lu Address: 0x%04X Command: 0x%02X\n",
+           (unsigned long)micros(), data.address, data.command);
+  }
+}
+
+int main(void)
+{
+  // Start with an idle line and a known clock
+  CIRL_Host::reset();
+  if (!IRLremote.begin(pinIR)) {
+    printf("You did not choose a valid pin.\n");
+    return 1;
+  }
+  CIRL_Host::space(pinIR, 100000UL);
+
+  // Press a button and hold it down for two repeats
+  sendNec(0x2222, 0x02);
+  print();
+  CIRL_Host::space(pinIR, NEC_TIMING.spaceEnd);
+  for (uint8_t i = 0; i < 2; i++) {
+    sendNecHolding();
+    print();
+    CIRL_Host::space(pinIR, NEC_TIMING.spaceEndHolding);
+  }
+
+  IRLremote.end(pinIR);
+  return 0;
+}
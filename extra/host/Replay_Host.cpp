@@ -0,0 +1,395 @@
+/*
+  Copyright (c) 2014-2018 NicoHood
+  See the readme for credit to other people.
+
+  IRL Replay_Host
+
+  Replays recorded IR captures (see src/IRL_Capture.h) through the NEC,
+  Panasonic and HashIR interrupt functions with the virtual host clock.
+  The files are memory mapped, so captures of several GB can be replayed.
+  The decoded frames and the decoding speed in edges/s are printed.
+
+  Compile and run on Linux/macOS:
+  g++ -std=gnu++11 -O2 -I../../src Replay_Host.cpp ../../src/IRLremote.cpp -o Replay_Host
+
+  Replay captures, -v prints every decoded frame. -c decodes the captures
+  again with CIRL_Batch (like irl-decode) and fails if the number of frames
+  of any protocol differs:
+  ./Replay_Host [-v|-c] capture.irlc [more.irlc ...]
+
+  Generate a capture with random NEC (with holding) and Panasonic frames:
+  ./Replay_Host -g capture.irlc 1000
+*/
+
+#include "IRLremote.h"
+#include "IRL_Capture.h"
+#include "IRL_Batch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Every decoder has its own simulated pin
+#define pinNec 2
+#define pinPanasonic 3
+#define pinHash 4
+
+CNec nec;
+CPanasonic panasonic;
+CHashIR hash;
+
+// Offline decoder for -c, its instances are not used by the pins above
+typedef CIRL_Batch<CNecInstance<1>, CPanasonicInstance<1>, CHashIRInstance<1>> CDecoder;
+
+bool verbose = false;
+
+struct Result {
+  uint64_t edges = 0;
+  uint64_t nec = 0;
+  uint64_t panasonic = 0;
+  uint64_t hash = 0;
+  double seconds = 0;
+};
+
+//==============================================================================
+// Replay
+//==============================================================================
+
+static inline void edge(uint8_t level)
+{
+  CIRL_Host::write(pinNec, level);
+  CIRL_Host::write(pinPanasonic, level);
+  CIRL_Host::write(pinHash, level);
+}
+
+static inline void poll(Result &result)
+{
+  if (nec.available()) {
+    auto data = nec.read();
+    result.nec++;
+    if (verbose) {
+      printf("%10lu NEC       Address: 0x%04X Command: 0x%02X\n",
+             (unsigned long)micros(), data.address, data.command);
+    }
+  }
+  if (panasonic.available()) {
+    auto data = panasonic.read();
+    result.panasonic++;
+    if (verbose) {
+      printf("%10lu Panasonic Address: 0x%04X Command: 0x%08lX\n",
+             (unsigned long)micros(), data.address,
+             (unsigned long)data.command);
+    }
+  }
+  if (hash.available()) {
+    auto data = hash.read();
+    result.hash++;
+    if (verbose) {
+      printf("%10lu HashIR    Hash: 0x%08lX Length: %u\n",
+             (unsigned long)micros(), (unsigned long)data.command,
+             data.address);
+    }
+  }
+}
+
+// Maps a capture file and checks its header, returns nullptr on errors
+static const uint8_t *mapCapture(const char *path, size_t &length,
+                                 IRL_CaptureHeader_t &header)
+{
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    perror(path);
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) < 0 || st.st_size == 0) {
+    printf("%s: empty file\n", path);
+    close(fd);
+    return nullptr;
+  }
+  length = st.st_size;
+  void *map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    perror(path);
+    return nullptr;
+  }
+  madvise(map, length, MADV_SEQUENTIAL);
+
+  if (!CIRL_Capture::readHeader((const uint8_t *)map, length, header)) {
+    printf("%s: not a valid capture\n", path);
+    munmap(map, length);
+    return nullptr;
+  }
+  return (const uint8_t *)map;
+}
+
+bool replay(const char *path, Result &result)
+{
+  size_t length;
+  IRL_CaptureHeader_t header;
+  const uint8_t *map = mapCapture(path, length, header);
+  if (!map) {
+    return false;
+  }
+
+  const uint8_t *buffer = map + IRL_CAPTURE_HEADER_LENGTH;
+  const uint8_t *end = map + length;
+
+  // Every capture starts with an idle line and a fresh decoder state
+  uint8_t level = header.level;
+  edge(level);
+
+  timespec start, stop;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  uint64_t edges = 0;
+  while (buffer < end && (!header.edges || edges < header.edges))
+  {
+    uint32_t duration;
+    uint8_t read = CIRL_Capture::readDuration(buffer, end, duration);
+    if (!read) {
+      printf("%s: truncated after %llu edges\n", path,
+             (unsigned long long)edges);
+      break;
+    }
+    buffer += read;
+
+    // Advance over long spaces in steps and read the new frames after each.
+    // Frames completed by a timeout are only available within the space,
+    // and read() late in the space would hide the timeout of the next lead.
+    while (duration >= IRL_BATCH_LIMIT_POLL) {
+      poll(result);
+      CIRL_Host::advance(IRL_BATCH_LIMIT_POLL);
+      duration -= IRL_BATCH_LIMIT_POLL;
+    }
+    CIRL_Host::advance(duration);
+    level = !level;
+    edge(level);
+    edges++;
+  }
+
+  // Let the last frame time out
+  CIRL_Host::advance(200000UL);
+  poll(result);
+
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  result.edges += edges;
+  result.seconds += (stop.tv_sec - start.tv_sec) +
+                    (stop.tv_nsec - start.tv_nsec) / 1e9;
+
+  munmap((void *)map, length);
+  return true;
+}
+
+//==============================================================================
+// Check
+//==============================================================================
+
+// Counts the frames of the offline decoder
+struct Counter {
+  Result &result;
+
+  void operator()(const Nec_data_t &, uint64_t) { result.nec++; }
+  void operator()(const Panasonic_data_t &, uint64_t) { result.panasonic++; }
+  void operator()(const HashIR_data_t &, uint64_t) { result.hash++; }
+};
+
+// Decodes a capture with CIRL_Batch instead of the pin interrupts
+bool decode(const char *path, Result &result)
+{
+  size_t length;
+  IRL_CaptureHeader_t header;
+  const uint8_t *map = mapCapture(path, length, header);
+  if (!map) {
+    return false;
+  }
+
+  const uint8_t *buffer = map + IRL_CAPTURE_HEADER_LENGTH;
+  const uint8_t *end = map + length;
+  Counter counter = { result };
+  uint64_t edges = 0;
+  while (buffer < end && (!header.edges || edges < header.edges))
+  {
+    uint32_t duration;
+    uint8_t read = CIRL_Capture::readDuration(buffer, end, duration);
+    if (!read) {
+      break;
+    }
+    buffer += read;
+    CDecoder::decode(duration, counter);
+    edges++;
+  }
+  CDecoder::flush(counter);
+  result.edges += edges;
+
+  munmap((void *)map, length);
+  return true;
+}
+
+// Both decoding paths have to find the same frames
+static bool compare(const char *protocol, uint64_t replayed, uint64_t decoded)
+{
+  bool ok = replayed == decoded;
+  printf("Check %-9s replay %llu, batch %llu %s\n", protocol,
+         (unsigned long long)replayed, (unsigned long long)decoded,
+         ok ? "ok" : "MISMATCH");
+  return ok;
+}
+
+//==============================================================================
+// Generator
+//==============================================================================
+
+struct Writer {
+  FILE *file;
+  uint32_t edges;
+  uint8_t buffer[IRL_CAPTURE_DURATION_LENGTH];
+
+  void write(uint32_t duration) {
+    fwrite(buffer, CIRL_Capture::writeDuration(duration, buffer), 1, file);
+    edges++;
+  }
+
+  // A frame starts with the edge after the gap
+  void frame(uint32_t gap, const uint16_t *durations, uint8_t length) {
+    write(gap);
+    for (uint8_t i = 0; i < length; i++) {
+      write(durations[i]);
+    }
+  }
+};
+
+bool generate(const char *path, uint32_t frames)
+{
+  static constexpr IRL_Timing_t timingNec = CIRL_IRP::timing(NEC_IRP);
+  static constexpr IRL_Timing_t timingPanasonic = CIRL_IRP::timing(PANASONIC_IRP);
+
+  Writer writer = { fopen(path, "wb"), 0, { 0 } };
+  if (!writer.file) {
+    perror(path);
+    return false;
+  }
+
+  // The edge count is written when all frames are known
+  uint8_t header[IRL_CAPTURE_HEADER_LENGTH] = { 0 };
+  fwrite(header, sizeof(header), 1, writer.file);
+
+  uint16_t durations[2 + 2 * PANASONIC_TIMING.bits + 1];
+  uint32_t gap = 100000UL;
+  uint32_t nec = 0, panasonic = 0;
+  srand(1);
+  for (uint32_t i = 0; i < frames; i++)
+  {
+    uint8_t data[6];
+    for (uint8_t j = 0; j < sizeof(data); j++) {
+      data[j] = rand();
+    }
+
+    if (rand() & 1)
+    {
+      // NEC with inverted command and a random number of holding frames
+      data[3] = ~data[2];
+      writer.frame(gap, durations, CIRL_IRP::encode(timingNec, data, durations));
+      gap = timingNec.spaceEnd;
+      nec++;
+
+      uint8_t holding = rand() % 3;
+      for (uint8_t j = 0; j < holding; j++) {
+        writer.frame(gap, durations, CIRL_IRP::encodeHolding(timingNec, durations));
+        gap = timingNec.spaceEndHolding;
+        nec++;
+      }
+    }
+    else
+    {
+      // Panasonic with a valid XOR checksum
+      data[5] = data[2] ^ data[3] ^ data[4];
+      writer.frame(gap, durations, CIRL_IRP::encode(timingPanasonic, data, durations));
+      gap = timingPanasonic.spaceEnd;
+      panasonic++;
+    }
+  }
+
+  IRL_CaptureHeader_t info;
+  info.version = IRL_CAPTURE_VERSION;
+  info.level = HIGH;
+  info.protocol = IRL_CAPTURE_PROTOCOL_MIXED;
+  info.carrier = 38;
+  info.edges = writer.edges;
+  CIRL_Capture::writeHeader(info, header);
+  fseek(writer.file, 0, SEEK_SET);
+  fwrite(header, sizeof(header), 1, writer.file);
+  fclose(writer.file);
+
+  printf("%s: %lu edges, %lu NEC frames (including holding), %lu Panasonic frames\n",
+         path, (unsigned long)writer.edges, (unsigned long)nec,
+         (unsigned long)panasonic);
+  return true;
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+int main(int argc, char **argv)
+{
+  if (argc == 4 && !strcmp(argv[1], "-g")) {
+    return generate(argv[2], strtoul(argv[3], NULL, 0)) ? 0 : 1;
+  }
+
+  int first = 1;
+  bool check = false;
+  if (argc > 1 && !strcmp(argv[1], "-v")) {
+    verbose = true;
+    first++;
+  }
+  else if (argc > 1 && !strcmp(argv[1], "-c")) {
+    check = true;
+    first++;
+  }
+  if (first >= argc) {
+    printf("Usage: %s [-v|-c] capture.irlc [...]\n", argv[0]);
+    printf("       %s -g capture.irlc frames\n", argv[0]);
+    return 1;
+  }
+
+  CIRL_Host::reset();
+  nec.begin(pinNec);
+  bool all = panasonic.begin(pinPanasonic) && hash.begin(pinHash);
+  if (!all) {
+    // IRL_TIMER_CAPTURE only supports a single receiver
+    fprintf(stderr, "Only NEC is replayed, the other receivers can not start\n");
+  }
+
+  Result result;
+  bool ok = true;
+  for (int i = first; i < argc; i++) {
+    ok &= replay(argv[i], result);
+  }
+
+  printf("%llu edges, NEC %llu, Panasonic %llu, HashIR %llu frames\n",
+         (unsigned long long)result.edges, (unsigned long long)result.nec,
+         (unsigned long long)result.panasonic, (unsigned long long)result.hash);
+  if (result.seconds > 0) {
+    printf("%.0f edges/s\n", result.edges / result.seconds);
+  }
+
+  if (check)
+  {
+    Result expected;
+    for (int i = first; i < argc; i++) {
+      ok &= decode(argv[i], expected);
+    }
+    ok &= compare("NEC", result.nec, expected.nec);
+    if (all) {
+      ok &= compare("Panasonic", result.panasonic, expected.panasonic);
+      ok &= compare("HashIR", result.hash, expected.hash);
+    }
+  }
+  return ok ? 0 : 1;
+}
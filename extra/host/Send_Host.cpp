@@ -0,0 +1,79 @@
+/*
+  Copyright (c) 2014-2018 NicoHood
+  See the readme for credit to other people.
+
+  IRL Send_Host
+
+  Sends a NEC frame with the asynchronous sender on a PC. The timer
+  interrupt runs on the virtual clock, the output is recorded and looped
+  back into a NEC receiver on the same pin. The recorded timeline is
+  compared with the encoded schedule.
+
+  Compile and run on Linux/macOS:
+  g++ -std=gnu++11 -O2 -I../../src Send_Host.cpp ../../src/IRLremote.cpp -o Send_Host
+  ./Send_Host
+*/
+
+#include "IRLremote.h"
+#include "IRL_Send.h"
+#include <stdio.h>
+
+// Defines the timer interrupt on AVR, empty on host builds
+IRL_SEND_INTERRUPT
+
+#define pinIR 2
+
+CNec IRLremote;
+
+// Called from the timer interrupt when the frame and its gap were sent
+void sendDone(void)
+{
+  printf("%10u Send done\n", CIRL_Host::micros());
+}
+
+int main(void)
+{
+  CIRL_Host::reset();
+  IRLremote.begin(pinIR);
+
+  // The receiver requires an idle line before the first frame
+  CIRL_Host::advance(100000UL);
+  CIRL_Host::loopback(pinIR);
+  CIRL_Sender::begin();
+
+  // Timings are generated from the IRP notation at compile time
+  constexpr IRL_Timing_t timing = CIRL_IRP::timing(NEC_IRP);
+  uint8_t data[4] = { 0x34, 0x12, 0x56, uint8_t(~0x56) };
+
+  // write() returns immediately, the main loop keeps running
+  uint32_t start = CIRL_Host::micros();
+  CIRL_Sender::write(timing, data, sendDone);
+  while (CIRL_Sender::sending())
+  {
+    CIRL_Host::advance(100);
+    if (IRLremote.available())
+    {
+      auto data = IRLremote.read();
+      printf("%10u Address: 0x%04X Command: 0x%02X\n", CIRL_Host::micros(),
+             data.address, data.command);
+    }
+  }
+
+  // Compare the recorded output with the encoded durations
+  uint16_t durations[IRL_SEND_LENGTH];
+  uint8_t length = CIRL_IRP::encode(timing, data, durations);
+  uint8_t errors = 0;
+  for (uint8_t i = 0; i < length; i++)
+  {
+    uint32_t duration = CIRL_Host::timelineTime(i + 1) -
+                        CIRL_Host::timelineTime(i);
+    if (CIRL_Host::timelineCarrier(i) != ((i % 2) == 0) ||
+        duration != durations[i]) {
+      errors++;
+    }
+  }
+
+  printf("Sent %u durations at %u Hz in %u us, %u timeline errors\n",
+         length, CIRL_Host::frequency(), CIRL_Host::micros() - start, errors);
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,365 @@
+/*
+  Copyright (c) 2014-2018 NicoHood
+  See the readme for credit to other people.
+
+  IRL Stress_Host
+
+  Measures how the NEC, Panasonic and HashIR decoders behave with bad signals.
+  Random frames are sent with timing jitter, short glitches, dropped pulses
+  and background noise (for example sunlight) in front of each frame.
+  For every condition the miss rate (frame not decoded or wrong data) and
+  the false accept rate (wrong data that passed the checksum, or a frame
+  decoded from pure noise) are printed, together with the decoding speed.
+  HashIR has no checksum, a hash different from the clean frame counts as
+  miss and false accept. Run it before and after changing a decoding limit.
+
+  Compile and run on Linux/macOS:
+  g++ -std=gnu++11 -O2 -I../../src Stress_Host.cpp ../../src/IRLremote.cpp -o Stress_Host
+  ./Stress_Host [frames per condition] [seed]
+*/
+
+#include "IRLremote.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+// Every decoder has its own simulated pin
+#define pinNec 2
+#define pinPanasonic 3
+#define pinHash 4
+
+// Idle time before every frame, long enough to time out all decoders
+#define IDLE 100000UL
+
+CNec nec;
+CPanasonic panasonic;
+CHashIR hash;
+
+static constexpr IRL_Timing_t timingNec = NEC_TIMING;
+static constexpr IRL_Timing_t timingPanasonic = PANASONIC_TIMING;
+
+//==============================================================================
+// Signal impairments
+//==============================================================================
+
+struct Condition {
+  const char *name;
+  // Every duration is changed by a random value of +-jitter us
+  uint16_t jitter;
+  // Chance per duration (1/1000) of a 10-100us pulse of the other level
+  uint16_t glitch;
+  // Chance per mark (1/1000) that the receiver misses it completely
+  uint16_t drop;
+  // Number of random 20-300us marks in the idle time before the frame
+  uint8_t noise;
+  // Only send noise, no frames
+  bool noiseOnly;
+  // Oscillator error of the remote in percent, all durations are scaled
+  int8_t clock;
+};
+
+static const Condition conditions[] = {
+  { "clean",            0,   0,  0,  0, false, 0 },
+  { "jitter 50us",     50,   0,  0,  0, false, 0 },
+  { "jitter 100us",   100,   0,  0,  0, false, 0 },
+  { "jitter 200us",   200,   0,  0,  0, false, 0 },
+  { "jitter 300us",   300,   0,  0,  0, false, 0 },
+  { "jitter 400us",   400,   0,  0,  0, false, 0 },
+  { "glitch 0.2%",      0,   2,  0,  0, false, 0 },
+  { "glitch 1%",        0,  10,  0,  0, false, 0 },
+  { "drop 0.2%",        0,   0,  2,  0, false, 0 },
+  { "drop 1%",          0,   0, 10,  0, false, 0 },
+  { "noise 5 pulses",   0,   0,  0,  5, false, 0 },
+  { "noise 20 pulses",  0,   0,  0, 20, false, 0 },
+  { "clock -8%",        0,   0,  0,  0, false, -8 },
+  { "clock +10%",       0,   0,  0,  0, false, 10 },
+  { "clock +15%",       0,   0,  0,  0, false, 15 },
+  { "clock -8% +jit", 200,   0,  0,  0, false, -8 },
+  { "clock +15% +jit",200,   0,  0,  0, false, 15 },
+  { "clock +25% +jit",200,   0,  0,  0, false, 25 },
+  { "mixed",          100,   2,  2,  5, false, 0 },
+  { "noise only",       0,   0,  0, 50, true,  0 },
+};
+
+// Deterministic random numbers, results are comparable between runs
+static uint32_t seed = 1;
+static inline uint32_t random32(void)
+{
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return seed;
+}
+
+static inline uint32_t randomRange(uint32_t min, uint32_t max)
+{
+  return min + random32() % (max - min + 1);
+}
+
+// Durations before each edge, starting with the idle time (pin high).
+// Even indexes end with a falling edge (mark start), odd ones with a rising edge.
+typedef std::vector<uint32_t> Signal;
+
+Signal impair(const uint16_t *durations, uint8_t length, const Condition &c)
+{
+  Signal signal;
+
+  // Background noise in the idle time
+  uint32_t idle = IDLE;
+  for (uint8_t i = 0; i < c.noise; i++) {
+    uint32_t space = randomRange(500, IDLE / (c.noise + 1));
+    uint32_t mark = randomRange(20, 300);
+    signal.push_back(space);
+    signal.push_back(mark);
+    idle -= space + mark;
+  }
+  if (c.noiseOnly) {
+    return signal;
+  }
+  signal.push_back(idle);
+
+  for (uint8_t i = 0; i < length; i++)
+  {
+    int32_t d = (int32_t)durations[i] * (100 + c.clock) / 100;
+    if (c.jitter) {
+      d += (int32_t)randomRange(0, 2 * c.jitter) - c.jitter;
+    }
+    if (d < 1) {
+      d = 1;
+    }
+
+    // A missed mark merges the spaces before and after it
+    if ((i & 1) == 0 && i > 0 && i + 1 < length &&
+        c.drop && randomRange(0, 999) < c.drop)
+    {
+      signal.back() += d + (int32_t)durations[i + 1] * (100 + c.clock) / 100;
+      i++;
+      continue;
+    }
+
+    // A glitch splits the duration with a short pulse of the other level
+    if (c.glitch && d > 200 && randomRange(0, 999) < c.glitch)
+    {
+      uint32_t g = randomRange(10, 100);
+      uint32_t a = randomRange(1, d - g - 1);
+      signal.push_back(a);
+      signal.push_back(g);
+      signal.push_back(d - a - g);
+      continue;
+    }
+    signal.push_back(d);
+  }
+  return signal;
+}
+
+//==============================================================================
+// Decoders under test
+//==============================================================================
+
+struct Result {
+  uint32_t frames = 0;
+  uint32_t miss = 0;
+  uint32_t falseAccept = 0;
+  uint64_t edges = 0;
+  double seconds = 0;
+};
+
+// Sends the signal to a pin, every duration is followed by an edge.
+// The pin stays idle for the end time after the last edge.
+static void send(uint8_t pin, const Signal &signal, uint32_t end, Result &result)
+{
+  uint8_t level = HIGH;
+  for (uint32_t d : signal) {
+    CIRL_Host::advance(d);
+    level = !level;
+    CIRL_Host::write(pin, level);
+  }
+  CIRL_Host::advance(end);
+  result.edges += signal.size();
+}
+
+// Returns the decoded frames, true if one of them matched
+template<class T, class F>
+static uint8_t receive(T &receiver, F match, bool &matched)
+{
+  uint8_t frames = 0;
+  while (receiver.available()) {
+    auto data = receiver.read();
+    frames++;
+    if (match(data)) {
+      matched = true;
+    }
+  }
+  return frames;
+}
+
+static void count(Result &result, bool noiseOnly, uint8_t frames, bool matched)
+{
+  result.frames++;
+  if (noiseOnly) {
+    if (frames) {
+      result.falseAccept++;
+    }
+    return;
+  }
+  if (!matched) {
+    result.miss++;
+  }
+  if (frames > (matched ? 1 : 0)) {
+    result.falseAccept++;
+  }
+}
+
+void testNec(const Condition &c, Result &result)
+{
+  uint8_t data[4] = { (uint8_t)random32(), (uint8_t)random32(),
+                      (uint8_t)random32(), 0 };
+  data[3] = ~data[2];
+  uint16_t durations[2 + 2 * timingNec.bits + 1];
+  uint8_t length = CIRL_IRP::encode(timingNec, data, durations);
+  Signal signal = impair(durations, length, c);
+
+  timespec start, stop;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  send(pinNec, signal, timingNec.spaceEnd, result);
+  bool matched = false;
+  uint8_t frames = receive(nec, [&](Nec_data_t d) {
+    return d.address == (data[0] | (data[1] << 8)) && d.command == data[2];
+  }, matched);
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  result.seconds += (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9;
+  count(result, c.noiseOnly, frames, matched);
+}
+
+void testPanasonic(const Condition &c, Result &result)
+{
+  uint8_t data[6];
+  for (uint8_t i = 0; i < 5; i++) {
+    data[i] = random32();
+  }
+  data[5] = data[2] ^ data[3] ^ data[4];
+  uint16_t durations[2 + 2 * timingPanasonic.bits + 1];
+  uint8_t length = CIRL_IRP::encode(timingPanasonic, data, durations);
+  Signal signal = impair(durations, length, c);
+
+  timespec start, stop;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  send(pinPanasonic, signal, timingPanasonic.spaceEnd, result);
+  bool matched = false;
+  uint8_t frames = receive(panasonic, [&](Panasonic_data_t d) {
+    return d.address == (data[0] | (data[1] << 8)) &&
+           d.command == (data[2] | ((uint32_t)data[3] << 8) |
+                         ((uint32_t)data[4] << 16) | ((uint32_t)data[5] << 24));
+  }, matched);
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  result.seconds += (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9;
+  count(result, c.noiseOnly, frames, matched);
+}
+
+// HashIR decodes NEC frames. The hash of the clean frame is the reference.
+void testHash(const Condition &c, Result &result)
+{
+  static const Condition clean = { "", 0, 0, 0, 0, false, 0 };
+  uint8_t data[4] = { (uint8_t)random32(), (uint8_t)random32(),
+                      (uint8_t)random32(), 0 };
+  data[3] = ~data[2];
+  uint16_t durations[2 + 2 * timingNec.bits + 1];
+  uint8_t length = CIRL_IRP::encode(timingNec, data, durations);
+
+  Result ignore;
+  HashIR_data_t reference = { 0, 0 };
+  send(pinHash, impair(durations, length, clean), timingNec.spaceEnd, ignore);
+  while (hash.available()) {
+    reference = hash.read();
+  }
+
+  Signal signal = impair(durations, length, c);
+  timespec start, stop;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  send(pinHash, signal, timingNec.spaceEnd, result);
+  bool matched = false;
+  uint8_t frames = receive(hash, [&](HashIR_data_t d) {
+    return d.command == reference.command;
+  }, matched);
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  result.seconds += (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9;
+  count(result, c.noiseOnly, frames, matched);
+}
+
+//==============================================================================
+// Main
+//==============================================================================
+
+static void print(const Result &result, bool noiseOnly)
+{
+  if (noiseOnly) {
+    printf("       -");
+  }
+  else {
+    printf("  %5.2f%%", 100.0 * result.miss / result.frames);
+  }
+  printf(" %6.2f%%", 100.0 * result.falseAccept / result.frames);
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t frames = argc > 1 ? strtoul(argv[1], NULL, 0) : 2000;
+  seed = argc > 2 ? strtoul(argv[2], NULL, 0) : 1;
+  if (!frames || !seed) {
+    printf("Usage: %s [frames per condition] [seed]\n", argv[0]);
+    return 1;
+  }
+
+  CIRL_Host::reset();
+  nec.begin(pinNec);
+  panasonic.begin(pinPanasonic);
+  hash.begin(pinHash);
+
+  printf("%lu frames per condition, seed %lu\n",
+         (unsigned long)frames, (unsigned long)seed);
+#ifdef IRL_CALIBRATE
+  printf("Lead calibration: +-%d%%\n", IRL_CALIBRATE);
+#endif
+  printf("Limits: NEC logic %lu holding %lu lead %lu, "
+         "Panasonic logic %lu holding %lu lead %lu, HashIR tolerance 75%%\n\n",
+         (unsigned long)CIRL_IRP::limitLogic(timingNec),
+         (unsigned long)CIRL_IRP::limitHolding(timingNec),
+         (unsigned long)CIRL_IRP::limitLead(timingNec),
+         (unsigned long)CIRL_IRP::limitLogic(timingPanasonic),
+         (unsigned long)CIRL_IRP::limitHolding(timingPanasonic),
+         (unsigned long)CIRL_IRP::limitLead(timingPanasonic));
+  printf("%-16s %-16s %-16s %-16s\n", "", "NEC", "Panasonic", "HashIR");
+  printf("%-16s %s %s %s\n", "Condition",
+         "   miss   false", "   miss   false", "   miss   false");
+
+  Result totalNec, totalPanasonic, totalHash;
+  for (const Condition &c : conditions)
+  {
+    Result rNec, rPanasonic, rHash;
+    for (uint32_t i = 0; i < frames; i++) {
+      testNec(c, rNec);
+      testPanasonic(c, rPanasonic);
+      testHash(c, rHash);
+    }
+
+    printf("%-16s", c.name);
+    print(rNec, c.noiseOnly);
+    print(rPanasonic, c.noiseOnly);
+    print(rHash, c.noiseOnly);
+    printf("\n");
+
+    totalNec.edges += rNec.edges;
+    totalNec.seconds += rNec.seconds;
+    totalPanasonic.edges += rPanasonic.edges;
+    totalPanasonic.seconds += rPanasonic.seconds;
+    totalHash.edges += rHash.edges;
+    totalHash.seconds += rHash.seconds;
+  }
+
+  printf("\nDecoding speed (edges/s): NEC %.0f, Panasonic %.0f, HashIR %.0f\n",
+         totalNec.edges / totalNec.seconds,
+         totalPanasonic.edges / totalPanasonic.seconds,
+         totalHash.edges / totalHash.seconds);
+  return 0;
+}
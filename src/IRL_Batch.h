@@ -0,0 +1,196 @@
+/*
+Copyright (c) 2014-2018 NicoHood
+See the readme for credit to other people.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+// Include guard
+#pragma once
+
+#include "IRL_Platform.h"
+#include "IRL_Multi.h"
+
+#ifndef IRL_HOST
+#error "IRL_Batch.h decodes with the virtual clock and requires a host build."
+#endif
+
+// New frames are read before a space of this length is decoded. Every
+// protocol has such a gap between frames, and a recognized frame is kept
+// (and blocks its decoder) until then. Frames that are completed by a
+// timeout are read with the time of their last edge.
+#define IRL_BATCH_LIMIT_POLL IRL_MULTI_LIMIT_MARK
+
+// Gap that flush() adds after the last edge, it times out every protocol
+#define IRL_BATCH_FLUSH (1000UL * 1000UL) // 1 second
+
+//==============================================================================
+// IRL_Batch Class
+//==============================================================================
+
+// Decodes recorded edge durations (microseconds) without interrupts or pins.
+// The durations are decoded by CIRL_Multi like edges of a receiver, every
+// decoded frame is passed to the handler with its absolute time:
+//   void operator()(const Nec_data_t &data, uint64_t time);
+// The decoders and the batch time are static, like the state of every
+// receiver. A batch is not reentrant: use protocol instances (CNecInstance<1>)
+// that no receiver and no other batch of the same program uses, and only
+// decode one recording at a time with it. The virtual clock is set to the
+// edges while decoding and restored afterwards, so live receivers on the
+// virtual clock keep their timing.
+template<class... Protocols>
+class CIRL_Batch : protected CIRL_Multi<Protocols...>
+{
+public:
+    // Decodes the durations before each edge. The first duration is relative
+    // to the last edge of the previous call (or an idle line).
+    template<class Duration, class Handler>
+    static inline void decode(const Duration* durations, size_t length,
+                              Handler &handler);
+    template<class Handler>
+    static inline void decode(uint32_t duration, Handler &handler);
+
+    // Completes the last frames after the end of a recording
+    template<class Handler>
+    static inline void flush(Handler &handler);
+
+    // Absolute time of the last edge in microseconds
+    static inline uint64_t time(void);
+
+protected:
+    typedef CIRL_Multi<Protocols...> Multi;
+    typedef typename Multi::Time Time;
+    typedef typename Time::Timebase Timebase;
+
+    // Decodes a single duration, the virtual clock is set to its edge
+    template<class Handler>
+    static inline void decodeEdge(uint32_t duration, Handler &handler);
+
+    // Reads the new frames, now is the current absolute time
+    template<class Handler>
+    static inline void poll(Handler &handler, uint64_t now);
+    template<class P, class Handler>
+    static inline void pollProtocol(Handler &handler, uint64_t now);
+
+    static uint64_t mtime;
+};
+
+
+//==============================================================================
+// Static Data
+//==============================================================================
+
+template<class... Protocols>
+uint64_t CIRL_Batch<Protocols...>::mtime = 0;
+
+
+//==============================================================================
+// CIRL_Batch Implementation
+//==============================================================================
+
+template<class... Protocols>
+template<class Duration, class Handler>
+void CIRL_Batch<Protocols...>::decode(const Duration* durations, size_t length,
+                                      Handler &handler)
+{
+    uint32_t clock = CIRL_Host::micros();
+    for (size_t i = 0; i < length; i++) {
+        decodeEdge(durations[i], handler);
+    }
+    CIRL_Host::setMicros(clock);
+}
+
+
+template<class... Protocols>
+template<class Handler>
+void CIRL_Batch<Protocols...>::decode(uint32_t duration, Handler &handler)
+{
+    uint32_t clock = CIRL_Host::micros();
+    decodeEdge(duration, handler);
+    CIRL_Host::setMicros(clock);
+}
+
+
+template<class... Protocols>
+template<class Handler>
+void CIRL_Batch<Protocols...>::decodeEdge(uint32_t duration, Handler &handler)
+{
+    mtime += duration;
+    CIRL_Host::setMicros(mtime);
+
+    // Read the new frames in front of a long space
+    if (duration >= IRL_BATCH_LIMIT_POLL) {
+        poll(handler, mtime);
+    }
+
+    // Decode the edge like the interrupt of CIRL_Multi
+    uint16_t ticks = Time::nextTime();
+    if (!Time::glitch(ticks)) {
+        Multi::decode(ticks);
+    }
+}
+
+
+template<class... Protocols>
+template<class Handler>
+void CIRL_Batch<Protocols...>::flush(Handler &handler)
+{
+    // The next edge is relative to the last edge, the time keeps running
+    uint32_t clock = CIRL_Host::micros();
+    CIRL_Host::setMicros(mtime + IRL_BATCH_FLUSH);
+    poll(handler, mtime + IRL_BATCH_FLUSH);
+    CIRL_Host::setMicros(clock);
+}
+
+
+template<class... Protocols>
+uint64_t CIRL_Batch<Protocols...>::time(void)
+{
+    return mtime;
+}
+
+
+template<class... Protocols>
+template<class Handler>
+void CIRL_Batch<Protocols...>::poll(Handler &handler, uint64_t now)
+{
+    // The last edge may be held back by the glitch filter
+    Time::release();
+
+    int call[] = { 0, (pollProtocol<Protocols>(handler, now), 0)... };
+    (void)call;
+}
+
+
+template<class... Protocols>
+template<class P, class Handler>
+void CIRL_Batch<Protocols...>::pollProtocol(Handler &handler, uint64_t now)
+{
+    P protocol;
+    while (protocol.available())
+    {
+        auto data = protocol.read();
+        uint32_t event = protocol.readTime();
+
+        // Event times are 32 bit, the age of the frame is short
+        uint32_t age = Timebase::micros(Timebase::now() - event);
+        handler(data, now - age);
+    }
+}
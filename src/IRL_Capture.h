@@ -0,0 +1,182 @@
+/*
+Copyright (c) 2014-2018 NicoHood
+See the readme for credit to other people.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+// Include guard
+#pragma once
+
+#include "IRL_Platform.h"
+
+//==============================================================================
+// Capture Format
+//==============================================================================
+
+// Recorded edges of an IR receiver. All values are little endian.
+//
+// Header (16 bytes):
+//   0  "IRLC"   magic
+//   4  uint8_t  version
+//   5  uint8_t  level of the pin before the first edge (HIGH = idle)
+//   6  uint8_t  protocol that was sent, if known (IRL_CAPTURE_PROTOCOL_*)
+//   7  uint8_t  carrier frequency of the receiver in kHz, 0 if unknown
+//   8  uint32_t number of edges, 0 if unknown (read until the end)
+//  12  uint32_t reserved, 0
+//
+// Data: the duration in microseconds before each edge, the first one is
+// relative to the start of the capture. Every duration is a variable length
+// integer, 7 bit per byte (LSB first), the MSB flags a following byte.
+// Typical IR durations take two bytes.
+
+#define IRL_CAPTURE_VERSION         1
+#define IRL_CAPTURE_HEADER_LENGTH   16
+#define IRL_CAPTURE_DURATION_LENGTH 5
+
+#define IRL_CAPTURE_PROTOCOL_UNKNOWN    0
+#define IRL_CAPTURE_PROTOCOL_NEC        1
+#define IRL_CAPTURE_PROTOCOL_PANASONIC  2
+#define IRL_CAPTURE_PROTOCOL_SONY       3
+#define IRL_CAPTURE_PROTOCOL_RC5        4
+#define IRL_CAPTURE_PROTOCOL_RC6        5
+#define IRL_CAPTURE_PROTOCOL_MIXED      0xFF
+
+struct IRL_CaptureHeader_t
+{
+    uint8_t version;
+    uint8_t level;
+    uint8_t protocol;
+    uint8_t carrier;
+    uint32_t edges;
+};
+
+//==============================================================================
+// IRL_Capture Class
+//==============================================================================
+
+class CIRL_Capture
+{
+public:
+    // Header conversion, read returns false if it is not a valid capture
+    static inline void writeHeader(const IRL_CaptureHeader_t &header,
+                                   uint8_t* buffer);
+    static inline bool readHeader(const uint8_t* buffer, size_t length,
+                                  IRL_CaptureHeader_t &header);
+
+    // Writes a duration and returns the number of bytes (max 5)
+    static inline uint8_t writeDuration(uint32_t duration, uint8_t* buffer);
+
+    // Reads a duration and returns the number of bytes, 0 if truncated
+    static inline uint8_t readDuration(const uint8_t* buffer,
+                                       const uint8_t* end, uint32_t &duration);
+
+protected:
+    static inline void write32(uint32_t value, uint8_t* buffer);
+    static inline uint32_t read32(const uint8_t* buffer);
+};
+
+
+//==============================================================================
+// CIRL_Capture Implementation
+//==============================================================================
+
+void CIRL_Capture::writeHeader(const IRL_CaptureHeader_t &header,
+                               uint8_t* buffer)
+{
+    buffer[0] = 'I';
+    buffer[1] = 'R';
+    buffer[2] = 'L';
+    buffer[3] = 'C';
+    buffer[4] = header.version;
+    buffer[5] = header.level;
+    buffer[6] = header.protocol;
+    buffer[7] = header.carrier;
+    write32(header.edges, buffer + 8);
+    write32(0, buffer + 12);
+}
+
+
+bool CIRL_Capture::readHeader(const uint8_t* buffer, size_t length,
+                              IRL_CaptureHeader_t &header)
+{
+    if (length < IRL_CAPTURE_HEADER_LENGTH) {
+        return false;
+    }
+    if (buffer[0] != 'I' || buffer[1] != 'R' ||
+        buffer[2] != 'L' || buffer[3] != 'C') {
+        return false;
+    }
+    header.version = buffer[4];
+    header.level = buffer[5];
+    header.protocol = buffer[6];
+    header.carrier = buffer[7];
+    header.edges = read32(buffer + 8);
+    return header.version == IRL_CAPTURE_VERSION;
+}
+
+
+uint8_t CIRL_Capture::writeDuration(uint32_t duration, uint8_t* buffer)
+{
+    uint8_t length = 0;
+    while (duration >= 0x80)
+    {
+        buffer[length++] = (duration & 0x7F) | 0x80;
+        duration >>= 7;
+    }
+    buffer[length++] = duration;
+    return length;
+}
+
+
+uint8_t CIRL_Capture::readDuration(const uint8_t* buffer, const uint8_t* end,
+                                   uint32_t &duration)
+{
+    duration = 0;
+    for (uint8_t i = 0; i < IRL_CAPTURE_DURATION_LENGTH; i++)
+    {
+        if (buffer + i >= end) {
+            return 0;
+        }
+        duration |= (uint32_t)(buffer[i] & 0x7F) << (7 * i);
+        if (!(buffer[i] & 0x80)) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+
+void CIRL_Capture::write32(uint32_t value, uint8_t* buffer)
+{
+    buffer[0] = value;
+    buffer[1] = value >> 8;
+    buffer[2] = value >> 16;
+    buffer[3] = value >> 24;
+}
+
+
+uint32_t CIRL_Capture::read32(const uint8_t* buffer)
+{
+    return ((uint32_t)buffer[3] << 24) |
+           ((uint32_t)buffer[2] << 16) |
+           ((uint32_t)buffer[1] << 8)  |
+           ((uint32_t)buffer[0]);
+}
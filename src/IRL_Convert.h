@@ -0,0 +1,622 @@
+/*
+Copyright (c) 2014-2018 NicoHood
+See the readme for credit to other people.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+// Include guard
+#pragma once
+
+#include "IRL_Platform.h"
+#include "IRL_Nec.h"
+#include "IRL_Panasonic.h"
+#include <string.h> // memcpy(), memcmp()
+
+//==============================================================================
+// Convert Definitions
+//==============================================================================
+
+// Conversion of decoded data into timings and the LIRC mode2 and Pronto hex
+// text formats, and streaming parsers for both formats. Nothing is allocated,
+// the text is written into (and parsed from) buffers of the caller.
+//
+// mode2: one "pulse <us>" or "space <us>" per line, "timeout <us>" is a space.
+// Pronto: hex words "0000 <frequency> <once pairs> <repeat pairs> <bursts>",
+// one code per line. Bursts are in carrier cycles, mark first.
+
+// Maximum durations of an encoded frame (Panasonic, 48 bit)
+#define IRL_CONVERT_LENGTH      (2 + 2 * PANASONIC_TIMING.bits + 1)
+
+// Text length (with the terminating zero) of a frame with its gap and of a
+// Pronto code of two sequences with their durations. A Pronto sequence is
+// padded to full pairs, its gap is the last space. Every word takes 5 bytes.
+#define IRL_MODE2_TEXT(length)  (((length) + 1) * 17 + 1)
+#define IRL_PRONTO_WORDS(length) (((length) + 1) / 2 * 2)
+#define IRL_PRONTO_TEXT(length, repeatLength) \
+    ((4 + IRL_PRONTO_WORDS(length) + IRL_PRONTO_WORDS(repeatLength)) * 5)
+
+// Text length for any of the decoded frame functions
+#define IRL_CONVERT_TEXT        IRL_MODE2_TEXT(IRL_CONVERT_LENGTH)
+
+static_assert(IRL_CONVERT_TEXT >=
+              IRL_PRONTO_TEXT(IRL_CONVERT_LENGTH, IRL_CONVERT_LENGTH),
+              "IRL_CONVERT_TEXT is too short for Pronto codes");
+
+// Space in front of the first pulse of a parsed text
+#define IRL_CONVERT_IDLE        (100UL * 1000UL) // 100ms
+
+//==============================================================================
+// IRL_Convert Class
+//==============================================================================
+
+class CIRL_Convert
+{
+public:
+    // Durations (mark first, microseconds) of decoded data and the gap
+    // after the frame. Panasonic repeats the whole frame.
+    // NEC address 0xFFFF with command 0x00 is the holding frame, like the
+    // decoder reports it. A real frame with these values can not be encoded,
+    // the decoder can not tell both apart either.
+    static inline uint8_t encode(const Nec_data_t &data, uint16_t* durations,
+                                 uint32_t &gap);
+    static inline uint8_t encode(const Panasonic_data_t &data,
+                                 uint16_t* durations, uint32_t &gap);
+
+    // Writes the durations and the gap as text, returns the text length
+    static inline size_t writeMode2(const uint16_t* durations, uint8_t length,
+                                    uint32_t gap, char* text);
+    static inline size_t writePronto(uint32_t hz,
+                                     const uint16_t* durations, uint8_t length,
+                                     uint32_t gap,
+                                     const uint16_t* repeat, uint8_t repeatLength,
+                                     uint32_t repeatGap, char* text);
+
+    // Writes a decoded frame, Pronto with the holding frame as repeat sequence
+    template<class Protocol_data_t>
+    static inline size_t writeMode2(const Protocol_data_t &data, char* text);
+    static inline size_t writePronto(const Nec_data_t &data, char* text);
+    static inline size_t writePronto(const Panasonic_data_t &data, char* text);
+
+    // Pronto carrier frequency code and burst length conversion
+    static constexpr uint16_t prontoFrequency(uint32_t hz);
+    static constexpr uint32_t prontoHz(uint16_t frequency);
+    static constexpr uint32_t prontoCycles(uint32_t duration, uint16_t frequency);
+    static constexpr uint32_t prontoMicros(uint32_t cycles, uint16_t frequency);
+
+protected:
+    static inline uint8_t encode(const IRL_Timing_t &timing, const uint8_t* data,
+                                 bool holding, uint16_t* durations, uint32_t &gap);
+    static inline size_t writeNumber(uint32_t value, char* text);
+    static inline size_t writeHex(uint16_t value, char* text);
+};
+
+//==============================================================================
+// IRL_Mode2Parser Class
+//==============================================================================
+
+// Parses mode2 text in chunks of any size. Every pulse and space is passed
+// to the handler: void operator()(bool mark, uint32_t duration);
+// Other lines (comments, headers) are skipped.
+class CIRL_Mode2Parser
+{
+public:
+    template<class Handler>
+    inline void parse(const char* text, size_t length, Handler &handler);
+
+    // Passes the last value if the text did not end with a new line
+    template<class Handler>
+    inline void finish(Handler &handler);
+
+protected:
+    template<class Handler>
+    inline void line(Handler &handler);
+
+    // Current line: keyword, value and if the line is skipped
+    char mname[7];
+    uint8_t mkeyword = 0;
+    char mtype = 0;
+    uint32_t mvalue = 0;
+    bool mdigits = false;
+    bool mend = false;
+    bool mskip = false;
+};
+
+//==============================================================================
+// IRL_ProntoParser Class
+//==============================================================================
+
+// Parses Pronto hex codes (learned, 0000) in chunks of any size, one code
+// per line. The bursts are passed to the handler as soon as they are read:
+// void operator()(bool mark, uint32_t duration);
+// The once sequence is passed, followed by the repeat sequence if the once
+// sequence is empty or if the repeat sequence was requested.
+class CIRL_ProntoParser
+{
+public:
+    inline CIRL_ProntoParser(bool repeat = false) : mrepeat(repeat) {}
+
+    template<class Handler>
+    inline void parse(const char* text, size_t length, Handler &handler);
+    template<class Handler>
+    inline void finish(Handler &handler);
+
+    // Carrier frequency of the last code and the number of invalid codes
+    inline uint32_t frequency(void);
+    inline uint16_t errors(void);
+
+protected:
+    template<class Handler>
+    inline void word(Handler &handler);
+    inline void endCode(void);
+
+    bool mrepeat;
+    uint16_t mword = 0;
+    uint8_t mdigits = 0;
+    bool minvalid = false;
+
+    // Position in the current code and its header words
+    uint16_t mindex = 0;
+    uint16_t mfrequency = 0;
+    uint16_t monce = 0;
+    uint16_t mrepeats = 0;
+    uint16_t merrors = 0;
+};
+
+//==============================================================================
+// IRL_Edges Class
+//==============================================================================
+
+// Converts pulses and spaces into the durations before each edge, which the
+// decoders (CIRL_Batch) consume: void operator()(uint32_t duration);
+// Consecutive values of the same level are one duration.
+template<class Handler>
+class CIRL_Edges
+{
+public:
+    inline CIRL_Edges(Handler &handler) : mhandler(handler) {}
+
+    inline void operator()(bool mark, uint32_t duration);
+
+    // The last pulse ends with an edge to the idle level
+    inline void finish(void);
+
+protected:
+    Handler &mhandler;
+    bool mstarted = false;
+    bool mmark = false;
+    uint32_t mpending = 0;
+};
+
+
+//==============================================================================
+// CIRL_Convert Implementation
+//==============================================================================
+
+uint8_t CIRL_Convert::encode(const IRL_Timing_t &timing, const uint8_t* data,
+                             bool holding, uint16_t* durations, uint32_t &gap)
+{
+    if (holding && timing.markHolding) {
+        gap = timing.spaceEndHolding;
+        return CIRL_IRP::encodeHolding(timing, durations);
+    }
+    gap = timing.spaceEnd;
+    return CIRL_IRP::encode(timing, data, durations);
+}
+
+
+uint8_t CIRL_Convert::encode(const Nec_data_t &data, uint16_t* durations,
+                             uint32_t &gap)
+{
+    static constexpr IRL_Timing_t timing = CIRL_IRP::timing(NEC_IRP);
+    uint8_t bytes[4] = {
+        uint8_t(data.address), uint8_t(data.address >> 8),
+        data.command, uint8_t(~data.command)
+    };
+    bool holding = data.address == 0xFFFF && data.command == 0x00;
+    return encode(timing, bytes, holding, durations, gap);
+}
+
+
+uint8_t CIRL_Convert::encode(const Panasonic_data_t &data, uint16_t* durations,
+                             uint32_t &gap)
+{
+    static constexpr IRL_Timing_t timing = CIRL_IRP::timing(PANASONIC_IRP);
+    uint8_t bytes[6] = {
+        uint8_t(data.address), uint8_t(data.address >> 8),
+        uint8_t(data.command), uint8_t(data.command >> 8),
+        uint8_t(data.command >> 16), uint8_t(data.command >> 24)
+    };
+    return encode(timing, bytes, false, durations, gap);
+}
+
+
+size_t CIRL_Convert::writeNumber(uint32_t value, char* text)
+{
+    char digits[10];
+    uint8_t length = 0;
+    do {
+        digits[length++] = '0' + (value % 10);
+        value /= 10;
+    } while (value);
+
+    for (uint8_t i = 0; i < length; i++) {
+        text[i] = digits[length - 1 - i];
+    }
+    return length;
+}
+
+
+size_t CIRL_Convert::writeHex(uint16_t value, char* text)
+{
+    for (uint8_t i = 0; i < 4; i++) {
+        uint8_t nibble = (value >> (12 - 4 * i)) & 0x0F;
+        text[i] = nibble < 10 ? '0' + nibble : 'A' + nibble - 10;
+    }
+    return 4;
+}
+
+
+size_t CIRL_Convert::writeMode2(const uint16_t* durations, uint8_t length,
+                                uint32_t gap, char* text)
+{
+    size_t pos = 0;
+    for (uint8_t i = 0; i <= length; i++)
+    {
+        // Marks and spaces alternate, the gap is the last space
+        bool mark = (i % 2) == 0;
+        uint32_t duration = i < length ? durations[i] : gap;
+        if (i == length && mark) {
+            break;
+        }
+        memcpy(text + pos, mark ? "pulse " : "space ", 6);
+        pos += 6;
+        pos += writeNumber(duration, text + pos);
+        text[pos++] = '\n';
+    }
+    text[pos] = '\0';
+    return pos;
+}
+
+
+constexpr uint16_t CIRL_Convert::prontoFrequency(uint32_t hz)
+{
+    // The Pronto clock period is 0.241246us
+    return (4145146UL + hz / 2) / hz;
+}
+
+
+constexpr uint32_t CIRL_Convert::prontoHz(uint16_t frequency)
+{
+    return frequency ? (4145146UL + frequency / 2) / frequency : 0;
+}
+
+
+constexpr uint32_t CIRL_Convert::prontoCycles(uint32_t duration,
+                                              uint16_t frequency)
+{
+    return (uint64_t(duration) * 1000000ULL + uint64_t(frequency) * 241246ULL / 2) /
+           (uint64_t(frequency) * 241246ULL);
+}
+
+
+constexpr uint32_t CIRL_Convert::prontoMicros(uint32_t cycles,
+                                              uint16_t frequency)
+{
+    return (uint64_t(cycles) * frequency * 241246ULL + 500000ULL) / 1000000ULL;
+}
+
+
+size_t CIRL_Convert::writePronto(uint32_t hz,
+                                 const uint16_t* durations, uint8_t length,
+                                 uint32_t gap,
+                                 const uint16_t* repeat, uint8_t repeatLength,
+                                 uint32_t repeatGap, char* text)
+{
+    // Both sequences are mark/space pairs, the gap is the last space
+    uint16_t frequency = prontoFrequency(hz);
+    uint16_t words[4] = { 0x0000, frequency, uint16_t((length + 1) / 2),
+                          uint16_t((repeatLength + 1) / 2) };
+    size_t pos = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        pos += writeHex(words[i], text + pos);
+        text[pos++] = ' ';
+    }
+
+    for (uint8_t s = 0; s < 2; s++)
+    {
+        const uint16_t* sequence = s ? repeat : durations;
+        uint8_t count = s ? repeatLength : length;
+        count += count % 2;
+        for (uint8_t i = 0; i < count; i++)
+        {
+            uint32_t duration = (i == count - 1) ? (s ? repeatGap : gap) : sequence[i];
+            uint32_t cycles = prontoCycles(duration, frequency);
+            pos += writeHex(cycles > 0xFFFF ? 0xFFFF : cycles, text + pos);
+            text[pos++] = ' ';
+        }
+    }
+
+    // Replace the last separator
+    text[pos - 1] = '\0';
+    return pos - 1;
+}
+
+
+template<class Protocol_data_t>
+size_t CIRL_Convert::writeMode2(const Protocol_data_t &data, char* text)
+{
+    uint16_t durations[IRL_CONVERT_LENGTH];
+    uint32_t gap;
+    uint8_t length = encode(data, durations, gap);
+    return writeMode2(durations, length, gap, text);
+}
+
+
+size_t CIRL_Convert::writePronto(const Nec_data_t &data, char* text)
+{
+    uint16_t durations[IRL_CONVERT_LENGTH];
+    uint16_t repeat[3];
+    uint32_t gap, repeatGap;
+    uint8_t length = encode(data, durations, gap);
+    uint8_t repeatLength = encode(Nec_data_t{ 0xFFFF, 0x00 }, repeat, repeatGap);
+    return writePronto(NEC_TIMING.hz, durations, length, gap,
+                       repeat, repeatLength, repeatGap, text);
+}
+
+
+size_t CIRL_Convert::writePronto(const Panasonic_data_t &data, char* text)
+{
+    uint16_t durations[IRL_CONVERT_LENGTH];
+    uint32_t gap;
+    uint8_t length = encode(data, durations, gap);
+    return writePronto(PANASONIC_TIMING.hz, durations, length, gap,
+                       durations, length, gap, text);
+}
+
+//==============================================================================
+// CIRL_Mode2Parser Implementation
+//==============================================================================
+
+template<class Handler>
+void CIRL_Mode2Parser::parse(const char* text, size_t length, Handler &handler)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        char c = text[i];
+        if (c == '\n') {
+            line(handler);
+            continue;
+        }
+        if (mskip) {
+            continue;
+        }
+
+        // Keyword, followed by a space
+        if (!mtype)
+        {
+            if (c != ' ') {
+                if (mkeyword < sizeof(mname)) {
+                    mname[mkeyword++] = c;
+                }
+                else {
+                    mskip = true;
+                }
+            }
+            else if (mkeyword == 5 && !memcmp(mname, "pulse", 5)) {
+                mtype = 'p';
+            }
+            else if ((mkeyword == 5 && !memcmp(mname, "space", 5)) ||
+                     (mkeyword == 7 && !memcmp(mname, "timeout", 7))) {
+                mtype = 's';
+            }
+            else {
+                mskip = true;
+            }
+        }
+
+        // Value, trailing characters are ignored
+        else if (c >= '0' && c <= '9' && !mend) {
+            mvalue = mvalue * 10 + (c - '0');
+            mdigits = true;
+        }
+        else {
+            mend = mdigits;
+        }
+    }
+}
+
+
+template<class Handler>
+void CIRL_Mode2Parser::line(Handler &handler)
+{
+    if (mtype && mdigits && !mskip) {
+        handler(mtype == 'p', mvalue);
+    }
+    mkeyword = 0;
+    mtype = 0;
+    mvalue = 0;
+    mdigits = false;
+    mend = false;
+    mskip = false;
+}
+
+
+template<class Handler>
+void CIRL_Mode2Parser::finish(Handler &handler)
+{
+    line(handler);
+}
+
+//==============================================================================
+// CIRL_ProntoParser Implementation
+//==============================================================================
+
+template<class Handler>
+void CIRL_ProntoParser::parse(const char* text, size_t length, Handler &handler)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        char c = text[i];
+        uint8_t nibble;
+        if (c >= '0' && c <= '9') {
+            nibble = c - '0';
+        }
+        else if (c >= 'A' && c <= 'F') {
+            nibble = c - 'A' + 10;
+        }
+        else if (c >= 'a' && c <= 'f') {
+            nibble = c - 'a' + 10;
+        }
+        else
+        {
+            // Words are separated by whitespace, every line is a code
+            if (mdigits) {
+                word(handler);
+            }
+            if (c == '\n') {
+                endCode();
+            }
+            else if (c != ' ' && c != '\t' && c != '\r') {
+                minvalid = true;
+            }
+            continue;
+        }
+
+        if (mdigits < 4) {
+            mword = (mword << 4) | nibble;
+            mdigits++;
+        }
+        else {
+            minvalid = true;
+        }
+    }
+}
+
+
+template<class Handler>
+void CIRL_ProntoParser::word(Handler &handler)
+{
+    uint16_t value = mword;
+    mword = 0;
+    mdigits = 0;
+    if (minvalid) {
+        return;
+    }
+
+    // Header: learned code, frequency and the length of both sequences
+    uint16_t index = mindex++;
+    if (index == 0) {
+        minvalid = value != 0x0000;
+    }
+    else if (index == 1) {
+        mfrequency = value;
+        minvalid = value == 0;
+    }
+    else if (index == 2) {
+        monce = value;
+    }
+    else if (index == 3) {
+        mrepeats = value;
+    }
+
+    // Bursts are passed as soon as they are read
+    else
+    {
+        uint16_t burst = index - 4;
+        if (burst >= 2 * (monce + mrepeats)) {
+            minvalid = true;
+        }
+        else if (burst < 2 * monce || !monce || mrepeat) {
+            handler((burst % 2) == 0,
+                    CIRL_Convert::prontoMicros(value, mfrequency));
+        }
+    }
+}
+
+
+void CIRL_ProntoParser::endCode(void)
+{
+    // Empty lines are skipped, codes must have all announced bursts
+    if (minvalid || (mindex && mindex != 4 + 2 * (monce + mrepeats))) {
+        merrors++;
+    }
+    mindex = 0;
+    minvalid = false;
+}
+
+
+template<class Handler>
+void CIRL_ProntoParser::finish(Handler &handler)
+{
+    if (mdigits) {
+        word(handler);
+    }
+    if (mindex || minvalid) {
+        endCode();
+    }
+}
+
+
+uint32_t CIRL_ProntoParser::frequency(void)
+{
+    return CIRL_Convert::prontoHz(mfrequency);
+}
+
+
+uint16_t CIRL_ProntoParser::errors(void)
+{
+    return merrors;
+}
+
+//==============================================================================
+// CIRL_Edges Implementation
+//==============================================================================
+
+template<class Handler>
+void CIRL_Edges<Handler>::operator()(bool mark, uint32_t duration)
+{
+    // The edge at the start of the first pulse follows an idle line
+    if (!mstarted) {
+        mstarted = true;
+        mmark = false;
+        mpending = mark ? IRL_CONVERT_IDLE : 0;
+    }
+    if (mark == mmark) {
+        mpending += duration;
+        return;
+    }
+
+    // The level changed, the previous value ended with this edge
+    mhandler(mpending);
+    mpending = duration;
+    mmark = mark;
+}
+
+
+template<class Handler>
+void CIRL_Edges<Handler>::finish(void)
+{
+    if (mmark) {
+        mhandler(mpending);
+        mpending = 0;
+        mmark = false;
+    }
+}
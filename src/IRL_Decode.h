@@ -25,6 +25,12 @@ THE SOFTWARE.
 #pragma once
 
 #include "IRL_Platform.h"
+#include "IRL_Profiler.h"
+
+// Lead calibration: the logic limit of CIRL_DecodeSpaces is scaled with the
+// measured lead, for remotes with an inaccurate (RC) oscillator.
+// Define the maximum correction in percent before including IRLremote.
+//#define IRL_CALIBRATE 15
 
 //==============================================================================
 // CIRL_DecodeSpaces Class
@@ -48,6 +54,16 @@ protected:
     static void interrupt(void);
     static constexpr uint8_t interruptMode = FALLING;
 
+    // Decode the duration of a mark + space
+    static inline void decode(uint16_t duration);
+    static inline void decodeSpace(uint16_t duration);
+
+#ifdef IRL_CALIBRATE
+    // Logic limit of the current frame, scaled with the measured lead
+    static inline void calibrate(uint16_t duration);
+    static uint16_t mlimitLogic;
+#endif
+
     // Interface that is required to be implemented
     //static inline bool checksum(void);
     //static inline void holding(void);
@@ -57,6 +73,7 @@ protected:
     //static constexpr uint32_t limitLogic = VALUE;
     //static constexpr uint32_t limitRepeat = VALUE;
     //static constexpr uint8_t irLength = VALUE;
+    //static constexpr uint32_t logicalLead = VALUE; // IRL_CALIBRATE only
 };
 
 
@@ -69,6 +86,10 @@ template<class T, int blocks>
 volatile uint8_t CIRL_DecodeSpaces<T, blocks>::count = 0;
 template<class T, int blocks>
 uint8_t CIRL_DecodeSpaces<T, blocks>::data[blocks] = { 0 };
+#ifdef IRL_CALIBRATE
+template<class T, int blocks>
+uint16_t CIRL_DecodeSpaces<T, blocks>::mlimitLogic = 0;
+#endif
 
 
 //==============================================================================
@@ -77,7 +98,14 @@ uint8_t CIRL_DecodeSpaces<T, blocks>::data[blocks] = { 0 };
 
 template<class T, int blocks>
 bool CIRL_DecodeSpaces<T, blocks>::available(void){
+#ifdef IRL_DEFERRED_DECODE
+    T::poll();
+#endif
+#ifdef IRL_FRAME_QUEUE
+    return T::queueAvailable();
+#else
     return count > (T::irLength / 2);
+#endif
 }
 
 
@@ -91,16 +119,60 @@ void CIRL_DecodeSpaces<T, blocks>::resetReading(void){
 template<class T, int blocks>
 void CIRL_DecodeSpaces<T, blocks>::interrupt(void)
 {
+#ifdef IRL_DEFERRED_DECODE
+    // Only save the time, decoding is done in the main loop
+    T::capture();
+#else
+    IRL_PROFILE_START(T);
+
     // Block if the protocol is already recognized
     if (count > (T::irLength / 2)) {
+#ifdef IRL_STATISTICS
+        T::blocked(T::Timebase::edge(), T::timeLimit(T::limitTimeout));
+#endif
+        IRL_PROFILE_STOP(T);
         return;
     }
 
     // Get time between previous call and decode
-    auto duration = T::nextTime();
+    uint16_t duration = T::nextTime();
+    if (!T::glitch(duration)) {
+        decodeSpace(duration);
+    }
+    IRL_PROFILE_STOP(T);
+#endif
+}
+
+
+template<class T, int blocks>
+void CIRL_DecodeSpaces<T, blocks>::decode(uint16_t duration)
+{
+    IRL_PROFILE_START(T);
+
+    // Block if the protocol is already recognized
+    if (count > (T::irLength / 2)) {
+#ifdef IRL_STATISTICS
+        T::blocked(T::mlastTime, T::timeLimit(T::limitTimeout));
+#endif
+        IRL_PROFILE_STOP(T);
+        return;
+    }
 
+    decodeSpace(duration);
+    IRL_PROFILE_STOP(T);
+}
+
+
+template<class T, int blocks>
+void CIRL_DecodeSpaces<T, blocks>::decodeSpace(uint16_t duration)
+{
     // On a timeout abort pending readings and start next possible reading
-    if (duration >= T::limitTimeout) {
+    if (duration >= T::durationLimit(T::limitTimeout))
+    {
+        IRL_PROFILE_BRANCH(T, IRL_BRANCH_TIMEOUT);
+        if (count > 1) {
+            IRL_STATISTIC(T, timeout);
+        }
         count = 0;
     }
 
@@ -115,30 +187,41 @@ void CIRL_DecodeSpaces<T, blocks>::interrupt(void)
     else if (count == 1)
     {
         // Wrong lead
-        if (duration < T::limitHolding)
+        if (duration < T::durationLimit(T::limitHolding))
         {
+            IRL_PROFILE_BRANCH(T, IRL_BRANCH_LEAD);
+            IRL_STATISTIC(T, lead);
             count = 0;
             return;
         }
         // Check for a "button holding" lead
-        else if (duration < T::limitLead)
+        else if (duration < T::durationLimit(T::limitLead))
         {
+            IRL_PROFILE_BRANCH(T, IRL_BRANCH_HOLDING);
+
             // Abort if last valid button press is too long ago
             if ((T::mlastTime - \
                 T::mlastEvent) >= \
-                T::limitRepeat)
+                T::timeLimit(T::limitRepeat))
             {
+                IRL_STATISTIC(T, repeat);
                 count = 0;
                 return;
             }
 
             // Received a Nec Repeat signal
             // Next mark (stop bit) ignored due to detecting techniques
+            IRL_STATISTIC(T, frames);
             T::holding();
             count = (T::irLength / 2);
             T::mlastEvent = T::mlastTime;
         }
         // Else normal lead, continue processing
+#ifdef IRL_CALIBRATE
+        else {
+            calibrate(duration);
+        }
+#endif
     }
 
     // Check different logical space pulses (mark + space)
@@ -147,23 +230,32 @@ void CIRL_DecodeSpaces<T, blocks>::interrupt(void)
         // Get number of the Bits (starting from zero)
         // Substract the first lead pulse
         uint8_t length = count - 2;
+        IRL_PROFILE_BRANCH(T, IRL_BRANCH_DATA);
 
         // Move bits (MSB is zero)
         data[length / 8] >>= 1;
 
         // Set MSB if it's a logical one
-        if (duration >= T::limitLogic) {
+#ifdef IRL_CALIBRATE
+        if (duration >= mlimitLogic) {
+#else
+        if (duration >= T::durationLimit(T::limitLogic)) {
+#endif
             data[length / 8] |= 0x80;
         }
 
         // Last bit (stop bit following)
         if (count >= (T::irLength / 2))
         {
+            IRL_PROFILE_BRANCH(T, IRL_BRANCH_LAST);
+
             // Check if the protcol's command checksum is correct
             if (T::checksum()) {
+                IRL_STATISTIC(T, frames);
                 T::mlastEvent = T::mlastTime;
             }
             else {
+                IRL_STATISTIC(T, checksum);
                 count = 0;
                 return;
             }
@@ -172,8 +264,40 @@ void CIRL_DecodeSpaces<T, blocks>::interrupt(void)
 
     // Next reading, no errors
     count++;
+
+#ifdef IRL_FRAME_QUEUE
+    // Queue the new frame and wait for the next lead immediately
+    if (count > (T::irLength / 2)) {
+        T::queueFrame();
+        count = 0;
+    }
+#endif
 }
 
+#ifdef IRL_CALIBRATE
+template<class T, int blocks>
+void CIRL_DecodeSpaces<T, blocks>::calibrate(uint16_t duration)
+{
+    // Lead to logic limit ratio as 16 bit fixed point value, no division.
+    // The ratio is below 1, so the product always fits into 32 bit.
+    constexpr uint32_t limitLogic = T::durationLimit(T::limitLogic);
+    constexpr uint32_t factor = (limitLogic << 16) / T::durationLimit(T::logicalLead);
+    constexpr uint16_t limitMin = limitLogic * (100 - IRL_CALIBRATE) / 100;
+    constexpr uint16_t limitMax = limitLogic * (100 + IRL_CALIBRATE) / 100;
+    static_assert(T::limitLogic < T::logicalLead, "Invalid lead for calibration");
+
+    uint16_t limit = ((uint32_t)duration * factor) >> 16;
+    if (limit < limitMin) {
+        limit = limitMin;
+    }
+    else if (limit > limitMax) {
+        limit = limitMax;
+    }
+    mlimitLogic = limit;
+}
+#endif
+
+
 /*
  * Return true if we are currently receiving new data
  */
@@ -182,31 +306,750 @@ bool CIRL_DecodeSpaces<T, blocks>::receiving(void)
 {
     bool ret = false;
 
-    // Provess with interrupts disabled to avoid any conflicts
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#ifdef IRL_DEFERRED_DECODE
+    // Decoding runs in the main loop, no need to disable interrupts
+    uint32_t timeout = T::idleTime();
+    if (count != 0)
     {
-        // Check if we already recognized a timed out
-        if (count == 0) {
-            ret = false;
+        // Check for a new timeout
+        if (timeout >= T::timeLimit(T::limitTimeout))
+        {
+            if (count > 1 && count <= (T::irLength / 2)) {
+                IRL_STATISTIC(T, timeout);
+            }
+            count = 0;
+        }
+        // We are currently receiving
+        else {
+            ret = true;
         }
-        else
+    }
+#else
+    // Lock-free snapshot of the decoding state
+    uint8_t sequence;
+    uint8_t c;
+    uint32_t timeout;
+    do {
+        sequence = T::sequence();
+        c = count;
+        timeout = T::mlastTime;
+    } while (T::changed(sequence));
+
+    // Check if we already recognized a timed out
+    if (c != 0)
+    {
+        // Calculate difference between last interrupt and now
+        uint32_t time = T::Timebase::now();
+        timeout = time - timeout;
+
+        // Check for a new timeout
+        if (timeout >= T::timeLimit(T::limitTimeout))
         {
-            // Calculate difference between last interrupt and now
-            uint32_t timeout = T::mlastTime;
-            uint32_t time = micros();
-            timeout = time - timeout;
+            // Only reset if no edge was decoded since the snapshot
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+            {
+                if (T::changed(sequence)) {
+                    ret = true;
+                }
+                else
+                {
+                    if (c > 1 && c <= (T::irLength / 2)) {
+                        IRL_STATISTIC(T, timeout);
+                    }
+                    count = 0;
+                }
+            }
+        }
+        // We are currently receiving
+        else {
+            ret = true;
+        }
+    }
+#endif
 
-            // Check for a new timeout
-            if (timeout >= T::limitTimeout) {
-                count = 0;
-                ret = false;
+    return ret;
+}
+
+
+//==============================================================================
+// CIRL_DecodeMarks Class
+//==============================================================================
+
+/*
+ * Decodes protocols that encode the bits in the mark width (Sony).
+ * Every edge is decoded (CHANGE), odd counts are marks, even counts spaces.
+ * The number of bits is variable, a frame ends with a space >= limitTimeout.
+ * It is completed by the lead of the next (repeated) frame or by
+ * available()/receiving() when no more edges follow.
+ */
+template<class T, int blocks>
+class CIRL_DecodeMarks
+{
+public:
+    // User API to access library data
+    inline bool available(void);
+    inline bool receiving(void);
+
+protected:
+    // Temporary buffer to hold bytes for decoding the protocol
+    static volatile uint8_t count;
+    static uint8_t data[blocks];
+
+    // Number of bits of the last received frame
+    static uint8_t length;
+
+    // Interrupt function that is attached
+    inline void resetReading(void);
+    static void interrupt(void);
+    static constexpr uint8_t interruptMode = CHANGE;
+
+    // Decode the duration of a single mark or space
+    static inline void decode(uint16_t duration);
+    static inline void decodeMark(uint16_t duration);
+    static inline void decodeFrame(uint32_t time);
+    static inline void checkTimeout(void);
+
+    // Interface that is required to be implemented
+    //static inline bool checksum(uint8_t length);
+    //static constexpr uint32_t limitTimeout = VALUE;
+    //static constexpr uint32_t limitLead = VALUE;
+    //static constexpr uint32_t limitLogic = VALUE;
+    //static constexpr uint32_t limitSpace = VALUE;
+    //static constexpr uint8_t irLength = VALUE;
+};
+
+
+//==============================================================================
+// Static Data
+//==============================================================================
+
+// Protocol temporary data
+template<class T, int blocks>
+volatile uint8_t CIRL_DecodeMarks<T, blocks>::count = 0;
+template<class T, int blocks>
+uint8_t CIRL_DecodeMarks<T, blocks>::data[blocks] = { 0 };
+template<class T, int blocks>
+uint8_t CIRL_DecodeMarks<T, blocks>::length = 0;
+
+
+//==============================================================================
+// CIRL_DecodeMarks Implementation
+//==============================================================================
+
+template<class T, int blocks>
+bool CIRL_DecodeMarks<T, blocks>::available(void){
+    // The last frame of a series is completed after the timeout
+    checkTimeout();
+#ifdef IRL_FRAME_QUEUE
+    return T::queueAvailable();
+#else
+    return count > T::irLength;
+#endif
+}
+
+
+template<class T, int blocks>
+void CIRL_DecodeMarks<T, blocks>::resetReading(void){
+    // Reset reading
+    count = 0;
+
+#ifndef IRL_DEFERRED_DECODE
+    // read() sets the last interrupt time to now, which hides the short gap
+    // before the next frame. Edges were ignored since the end of the frame,
+    // so the next edge is a timeout again. A wrong lead is still rejected.
+    T::mlastTime = T::mlastEvent;
+#endif
+}
+
+
+template<class T, int blocks>
+void CIRL_DecodeMarks<T, blocks>::interrupt(void)
+{
+#ifdef IRL_DEFERRED_DECODE
+    // Only save the time, decoding is done in the main loop
+    T::capture();
+#else
+    // Block if the protocol is already recognized
+    if (count > T::irLength) {
+        return;
+    }
+
+    // Get time between previous call and decode
+    uint16_t duration = T::nextTime();
+    if (!T::glitch(duration)) {
+        decodeMark(duration);
+    }
+#endif
+}
+
+
+template<class T, int blocks>
+void CIRL_DecodeMarks<T, blocks>::decode(uint16_t duration)
+{
+    // Block if the protocol is already recognized
+    if (count > T::irLength) {
+        return;
+    }
+
+    decodeMark(duration);
+}
+
+
+template<class T, int blocks>
+void CIRL_DecodeMarks<T, blocks>::decodeMark(uint16_t duration)
+{
+    // On a timeout abort pending readings and start next possible reading
+    if (duration >= T::durationLimit(T::limitTimeout))
+    {
+        // A timeout completes the pending frame, like checkTimeout() does.
+        // Its last mark ended before the gap, whatever the length of the gap.
+        if (count > 2 && (count % 2) == 0) {
+            decodeFrame(T::mlastTime - duration);
+        }
+
+        // Wait for the lead mark, unless a frame is blocked until read()
+        if (count <= T::irLength) {
+            count = 1;
+        }
+        return;
+    }
+
+    // On a reset (error in decoding) wait for a timeout to start a new reading
+    else if (count == 0) {
+        return;
+    }
+
+    // Check Mark Lead
+    else if (count == 1)
+    {
+        // Wrong lead
+        if (duration < T::durationLimit(T::limitLead))
+        {
+            count = 0;
+            return;
+        }
+    }
+
+    // Spaces have a fixed length
+    else if ((count % 2) == 0)
+    {
+        // Wrong space or too many bits
+        if (duration >= T::durationLimit(T::limitSpace) || count >= T::irLength)
+        {
+            count = 0;
+            return;
+        }
+    }
+
+    // Check different logical mark pulses
+    else
+    {
+        // Data marks are shorter than the lead
+        if (duration >= T::durationLimit(T::limitLead))
+        {
+            count = 0;
+            return;
+        }
+
+        // Get number of the Bits (starting from zero)
+        // Substract the lead mark and space
+        uint8_t bit = (count - 3) / 2;
+
+        // Move bits (MSB is zero)
+        data[bit / 8] >>= 1;
+
+        // Set MSB if it's a logical one
+        if (duration >= T::durationLimit(T::limitLogic)) {
+            data[bit / 8] |= 0x80;
+        }
+    }
+
+    // Next reading, no errors
+    count++;
+}
+
+
+/*
+ * Completes the frame after its last mark. Time is the end of the last mark.
+ */
+template<class T, int blocks>
+void CIRL_DecodeMarks<T, blocks>::decodeFrame(uint32_t time)
+{
+    // Every bit has a mark and a space, except the last bit
+    uint8_t bits = (count - 2) / 2;
+    count = 0;
+
+    // Check if the protocol supports this frame length
+    if (!T::checksum(bits)) {
+        return;
+    }
+
+    // Align the last block, bits were shifted in from the MSB
+    if (bits % 8) {
+        data[bits / 8] >>= 8 - (bits % 8);
+    }
+    length = bits;
+    T::mlastEvent = time;
+
+#ifdef IRL_FRAME_QUEUE
+    // Queue the new frame and wait for the next lead immediately
+    T::queueFrame();
+#else
+    // Block until read()
+    count = T::irLength + 1;
+#endif
+}
+
+
+/*
+ * Completes a pending frame or aborts the reading after a timeout.
+ */
+template<class T, int blocks>
+void CIRL_DecodeMarks<T, blocks>::checkTimeout(void)
+{
+#ifdef IRL_DEFERRED_DECODE
+    // Decoding runs in the main loop, no need to disable interrupts
+    uint32_t timeout = T::idleTime();
+    if (count != 0 && count <= T::irLength && timeout >= T::timeLimit(T::limitTimeout))
+    {
+        if (count > 2 && (count % 2) == 0) {
+            decodeFrame(T::mlastTime);
+        }
+        else {
+            count = 0;
+        }
+    }
+#else
+    // The last edge of the frame may be held back by the glitch filter
+    T::release();
+
+    // Lock-free snapshot of the decoding state, see CIRL_DecodeSpaces
+    uint8_t sequence;
+    uint8_t c;
+    uint32_t lastTime;
+    do {
+        sequence = T::sequence();
+        c = count;
+        lastTime = T::mlastTime;
+    } while (T::changed(sequence));
+
+    if (c != 0 && c <= T::irLength)
+    {
+        // Calculate difference between last interrupt and now
+        uint32_t time = T::Timebase::now();
+        uint32_t timeout = time - lastTime;
+
+        if (timeout >= T::timeLimit(T::limitTimeout))
+        {
+            // Only complete the frame if no edge was decoded since the snapshot
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+            {
+                if (!T::changed(sequence))
+                {
+                    if (c > 2 && (c % 2) == 0) {
+                        decodeFrame(lastTime);
+                    }
+                    else {
+                        count = 0;
+                    }
+                }
             }
-            // We are currently receiving
-            else {
-                ret = true;
+        }
+    }
+#endif
+}
+
+
+/*
+ * Return true if we are currently receiving new data
+ */
+template<class T, int blocks>
+bool CIRL_DecodeMarks<T, blocks>::receiving(void)
+{
+    checkTimeout();
+    uint8_t c = count;
+    return c != 0 && c <= T::irLength;
+}
+
+
+//==============================================================================
+// CIRL_DecodeBiphase Class
+//==============================================================================
+
+/*
+ * Decodes bi-phase (Manchester) protocols (RC5, RC6).
+ * Every bit has two halves of one unit with different levels. Every edge
+ * (CHANGE) adds its duration as 1 to 3 unit samples of the current level.
+ * The first half of each bit gives the bit value, the second half is checked.
+ * Bits are saved MSB first. A frame is complete after the first half of the
+ * last bit, the second half might already be the idle level.
+ */
+template<class T, int blocks>
+class CIRL_DecodeBiphase
+{
+public:
+    // User API to access library data
+    inline bool available(void);
+    inline bool receiving(void);
+
+protected:
+    // Temporary buffer to hold bytes for decoding the protocol
+    static volatile uint8_t count;
+    static uint8_t data[blocks];
+
+    // Current unit sample, its level and the level of the first bit half
+    static uint8_t sample;
+    static bool mark;
+    static bool first;
+
+    // Decoding states
+    static constexpr uint8_t stateTimeout = 0;
+    static constexpr uint8_t stateLeadMark = 1;
+    static constexpr uint8_t stateLeadSpace = 2;
+    static constexpr uint8_t stateData = 3;
+    static constexpr uint8_t stateAvailable = 4;
+
+    // Interrupt function that is attached
+    inline void resetReading(void);
+    static void interrupt(void);
+    static constexpr uint8_t interruptMode = CHANGE;
+
+    // Decode the duration of a single mark or space
+    static inline void decode(uint16_t duration);
+    static inline void decodeBiphase(uint16_t duration);
+    static inline bool decodeSample(void);
+    static inline void decodeFrame(void);
+    static inline void startData(void);
+
+    // Interface that is required to be implemented
+    //static inline bool checksum(void);
+    //static constexpr uint32_t limitTimeout = VALUE;
+    //static constexpr uint32_t limitLeadMark = VALUE; // 0 for no lead
+    //static constexpr uint32_t limitLeadSpace = VALUE;
+    //static constexpr uint32_t limitUnit1 = VALUE; // Between 1 and 2 units
+    //static constexpr uint32_t limitUnit2 = VALUE; // Between 2 and 3 units
+    //static constexpr uint32_t limitUnit3 = VALUE; // Between 3 and 4 units
+    //static constexpr uint8_t bits = VALUE;
+    //static constexpr uint8_t doubleBit = VALUE; // Bit with 2 unit halves
+    //static constexpr bool markFirst = VALUE; // Logical 1 is mark + space
+};
+
+
+//==============================================================================
+// Static Data
+//==============================================================================
+
+// Protocol temporary data
+template<class T, int blocks>
+volatile uint8_t CIRL_DecodeBiphase<T, blocks>::count = 0;
+template<class T, int blocks>
+uint8_t CIRL_DecodeBiphase<T, blocks>::data[blocks] = { 0 };
+template<class T, int blocks>
+uint8_t CIRL_DecodeBiphase<T, blocks>::sample = 0;
+template<class T, int blocks>
+bool CIRL_DecodeBiphase<T, blocks>::mark = false;
+template<class T, int blocks>
+bool CIRL_DecodeBiphase<T, blocks>::first = false;
+
+
+//==============================================================================
+// CIRL_DecodeBiphase Implementation
+//==============================================================================
+
+template<class T, int blocks>
+bool CIRL_DecodeBiphase<T, blocks>::available(void){
+#ifdef IRL_DEFERRED_DECODE
+    T::poll();
+#else
+    // The last edge of the frame may be held back by the glitch filter
+    T::release();
+#endif
+#ifdef IRL_FRAME_QUEUE
+    return T::queueAvailable();
+#else
+    return count == stateAvailable;
+#endif
+}
+
+
+template<class T, int blocks>
+void CIRL_DecodeBiphase<T, blocks>::resetReading(void){
+    // Reset reading
+    count = stateTimeout;
+
+#ifndef IRL_DEFERRED_DECODE
+    // Edges were ignored since the end of the frame, see CIRL_DecodeMarks
+    T::mlastTime = T::mlastEvent;
+#endif
+}
+
+
+template<class T, int blocks>
+void CIRL_DecodeBiphase<T, blocks>::interrupt(void)
+{
+#ifdef IRL_DEFERRED_DECODE
+    // Only save the time, decoding is done in the main loop
+    T::capture();
+#else
+    // Block if the protocol is already recognized
+    if (count == stateAvailable) {
+        return;
+    }
+
+    // Get time between previous call and decode
+    uint16_t duration = T::nextTime();
+    if (!T::glitch(duration)) {
+        decodeBiphase(duration);
+    }
+#endif
+}
+
+
+template<class T, int blocks>
+void CIRL_DecodeBiphase<T, blocks>::decode(uint16_t duration)
+{
+    // Block if the protocol is already recognized
+    if (count == stateAvailable) {
+        return;
+    }
+
+    decodeBiphase(duration);
+}
+
+
+/*
+ * The first mark after the lead (or the timeout) is the first data sample.
+ * Without lead the first half of the start bit is the idle space.
+ */
+template<class T, int blocks>
+void CIRL_DecodeBiphase<T, blocks>::startData(void)
+{
+    count = stateData;
+    mark = true;
+    if (T::limitLeadMark) {
+        sample = 0;
+    }
+    else
+    {
+        sample = 1;
+        first = false;
+        if (first == T::markFirst) {
+            data[0] |= 0x80;
+        }
+        else {
+            data[0] &= ~0x80;
+        }
+    }
+}
+
+
+template<class T, int blocks>
+void CIRL_DecodeBiphase<T, blocks>::decodeBiphase(uint16_t duration)
+{
+    // On a timeout abort pending readings and start next possible reading
+    if (duration >= T::durationLimit(T::limitTimeout))
+    {
+        if (T::limitLeadMark) {
+            count = stateLeadMark;
+        }
+        else {
+            startData();
+        }
+        return;
+    }
+
+    // On a reset (error in decoding) wait for a timeout to start a new reading
+    else if (count == stateTimeout) {
+        return;
+    }
+
+    // Check lead mark and space
+    else if (count == stateLeadMark)
+    {
+        if (duration < T::durationLimit(T::limitLeadMark)) {
+            count = stateTimeout;
+        }
+        else {
+            count = stateLeadSpace;
+        }
+        return;
+    }
+    else if (count == stateLeadSpace)
+    {
+        if (duration < T::durationLimit(T::limitUnit1) || duration >= T::durationLimit(T::limitLeadSpace)) {
+            count = stateTimeout;
+        }
+        else {
+            startData();
+        }
+        return;
+    }
+
+    // Convert the duration into 1 to 3 samples of one unit
+    uint8_t units = 1;
+    if (duration >= T::durationLimit(T::limitUnit1))
+    {
+        units = 2;
+        if (duration >= T::durationLimit(T::limitUnit2))
+        {
+            units = 3;
+            if (duration >= T::durationLimit(T::limitUnit3))
+            {
+                count = stateTimeout;
+                return;
+            }
+        }
+    }
+
+    // Decode every sample, stop on errors and on the last bit
+    do {
+        if (decodeSample()) {
+            return;
+        }
+    } while (--units);
+
+    // The next edge has the opposite level
+    mark = !mark;
+}
+
+
+/*
+ * Decodes the current sample. Returns true if the reading is finished.
+ */
+template<class T, int blocks>
+bool CIRL_DecodeBiphase<T, blocks>::decodeSample(void)
+{
+    uint8_t i = sample++;
+
+    // The double bit has halves of two units, use every 2nd unit only
+    if (i >= (T::doubleBit * 2))
+    {
+        if (i < (T::doubleBit * 2 + 4))
+        {
+            if ((i - (T::doubleBit * 2)) % 2) {
+                return false;
+            }
+            i = (T::doubleBit * 2) + ((i - (T::doubleBit * 2)) / 2);
+        }
+        else {
+            i -= 2;
+        }
+    }
+    uint8_t bit = i / 2;
+
+    // Second half: the level has to change
+    if (i % 2)
+    {
+        if (mark == first)
+        {
+            count = stateTimeout;
+            return true;
+        }
+        return false;
+    }
+
+    // First half: set or clear the bit (MSB first)
+    first = mark;
+    uint8_t mask = 0x80 >> (bit % 8);
+    if (mark == T::markFirst) {
+        data[bit / 8] |= mask;
+    }
+    else {
+        data[bit / 8] &= ~mask;
+    }
+
+    // Last bit, its second half might already be the idle level
+    if (bit == (T::bits - 1))
+    {
+        decodeFrame();
+        return true;
+    }
+    return false;
+}
+
+
+template<class T, int blocks>
+void CIRL_DecodeBiphase<T, blocks>::decodeFrame(void)
+{
+    // Check if the protcol's checksum is correct
+    if (!T::checksum())
+    {
+        count = stateTimeout;
+        return;
+    }
+    T::mlastEvent = T::mlastTime;
+
+#ifdef IRL_FRAME_QUEUE
+    // Queue the new frame, the next reading requires a timeout
+    T::queueFrame();
+    count = stateTimeout;
+#else
+    // Block until read()
+    count = stateAvailable;
+#endif
+}
+
+
+/*
+ * Return true if we are currently receiving new data
+ */
+template<class T, int blocks>
+bool CIRL_DecodeBiphase<T, blocks>::receiving(void)
+{
+    bool ret = false;
+
+#ifdef IRL_DEFERRED_DECODE
+    // Decoding runs in the main loop, no need to disable interrupts
+    uint32_t timeout = T::idleTime();
+    if (count != stateTimeout && count != stateAvailable)
+    {
+        // Check for a new timeout
+        if (timeout >= T::timeLimit(T::limitTimeout)) {
+            count = stateTimeout;
+        }
+        // We are currently receiving
+        else {
+            ret = true;
+        }
+    }
+#else
+    T::release();
+
+    // Lock-free snapshot of the decoding state, see CIRL_DecodeSpaces
+    uint8_t sequence;
+    uint8_t c;
+    uint32_t timeout;
+    do {
+        sequence = T::sequence();
+        c = count;
+        timeout = T::mlastTime;
+    } while (T::changed(sequence));
+
+    if (c != stateTimeout && c != stateAvailable)
+    {
+        // Calculate difference between last interrupt and now
+        uint32_t time = T::Timebase::now();
+        timeout = time - timeout;
+
+        // Check for a new timeout
+        if (timeout >= T::timeLimit(T::limitTimeout))
+        {
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+            {
+                if (T::changed(sequence)) {
+                    ret = true;
+                }
+                else {
+                    count = stateTimeout;
+                }
             }
         }
+        // We are currently receiving
+        else {
+            ret = true;
+        }
     }
+#endif
 
     return ret;
 }
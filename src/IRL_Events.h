@@ -0,0 +1,286 @@
+/*
+Copyright (c) 2014-2018 NicoHood
+See the readme for credit to other people.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+// Include guard
+#pragma once
+
+#include "IRL_Nec.h"
+#include "IRL_Sony.h"
+#include "IRL_RC5.h"
+#include "IRL_RC6.h"
+
+//==============================================================================
+// Event Definitions
+//==============================================================================
+
+// Number of events (power of two, max 128) that can be queued per receiver.
+// Define before including IRLremote or pass it as template parameter.
+#ifndef IRL_EVENT_QUEUE
+#define IRL_EVENT_QUEUE 8
+#endif
+
+// A new press of the same button within this time continues the press series
+#define IRL_EVENT_PRESS_TIMEOUT (500UL * 1000UL) // 0.5 seconds
+
+enum IRL_EventType : uint8_t
+{
+    IRL_EVENT_NONE,
+    IRL_EVENT_PRESS,    // Button was pressed, count is the press series
+    IRL_EVENT_HOLD,     // Button is still held down, duration increases
+    IRL_EVENT_RELEASE,  // Button was released or another button was pressed
+    IRL_EVENT_END,      // Press series is over (IRL_EVENT_PRESS_TIMEOUT)
+};
+
+struct IRL_Event_t
+{
+    IRL_EventType type;
+    // Presses of the same button in a row
+    uint8_t count;
+    // Received frames of the current press (1 + holding frames)
+    uint8_t duration;
+    uint16_t address;
+    uint32_t command;
+};
+
+// Protocol specific holding detection. By default a button is held down while
+// the same frame is repeated (Panasonic, HashIR).
+template<class Protocol_data_t>
+struct IRL_EventTraits
+{
+    // Holding frame without data
+    static inline bool repeat(const Protocol_data_t&) { return false; }
+
+    // Both frames belong to the same button
+    static inline bool same(const Protocol_data_t& a, const Protocol_data_t& b) {
+        return a.address == b.address && a.command == b.command;
+    }
+
+    // The button was pressed again in between
+    static inline bool toggled(const Protocol_data_t&, const Protocol_data_t&) {
+        return false;
+    }
+};
+
+// NEC sends a holding frame, flagged with address 0xFFFF
+template<>
+inline bool IRL_EventTraits<Nec_data_t>::repeat(const Nec_data_t& data) {
+    return data.address == 0xFFFF;
+}
+
+// Sony has no toggle bit. The same key sends the same data with the same
+// length, 12, 15 and 20 bit frames can have equal address and command values.
+template<>
+inline bool IRL_EventTraits<Sony_data_t>::same(const Sony_data_t& a, const Sony_data_t& b) {
+    return a.length == b.length && a.address == b.address && a.command == b.command;
+}
+
+// RC5 and RC6 change the toggle bit with every new press of a button
+template<>
+inline bool IRL_EventTraits<RC5_data_t>::toggled(const RC5_data_t& a, const RC5_data_t& b) {
+    return a.toggle != b.toggle;
+}
+
+template<>
+inline bool IRL_EventTraits<RC6_data_t>::toggled(const RC6_data_t& a, const RC6_data_t& b) {
+    return a.toggle != b.toggle;
+}
+
+//==============================================================================
+// IRL_Events Class
+//==============================================================================
+
+// Press, hold and release detection for any protocol. The frames are read in
+// the main loop and the events are saved in a queue, so they can be processed
+// in batches. A button is released if no frame was received for two frame
+// timespans, a single lost holding frame does not end the press.
+template<class Receiver, uint8_t size = IRL_EVENT_QUEUE>
+class CIRL_Events : public Receiver
+{
+public:
+    // Reads new frames and detects releases, call it frequently
+    inline void process(void);
+
+    // Returns the next event (after processing) or false if there is none
+    inline bool readEvent(IRL_Event_t &event);
+
+    // Number of events that were dropped because the queue was full
+    inline uint16_t droppedEvents(void);
+
+protected:
+    typedef decltype(Receiver::getData()) Protocol_data_t;
+    typedef IRL_EventTraits<Protocol_data_t> Traits;
+    typedef typename Receiver::Timebase Timebase;
+
+    // Timeouts in ticks of the receiver timebase
+    static constexpr uint32_t releaseTimeout =
+        Timebase::ticks(2 * Receiver::timespanEvent);
+    static constexpr uint32_t pressTimeout =
+        Timebase::ticks(IRL_EVENT_PRESS_TIMEOUT);
+
+    static_assert(size >= 2 && size <= 128 && (size & (size - 1)) == 0,
+                  "Event queue size must be a power of two between 2 and 128");
+
+    inline void frame(const Protocol_data_t &data, uint32_t time);
+    inline void release(uint32_t time);
+    inline void push(IRL_EventType type);
+
+    // Last button and the time of its last frame
+    Protocol_data_t mlast = Protocol_data_t();
+    uint32_t mframeTime = 0;
+    bool mpressed = false;
+    uint8_t mcount = 0;
+    uint8_t mduration = 0;
+
+    IRL_Event_t mevents[size];
+    uint8_t mhead = 0;
+    uint8_t mtail = 0;
+    uint16_t mdropped = 0;
+};
+
+
+//==============================================================================
+// CIRL_Events Implementation
+//==============================================================================
+
+template<class Receiver, uint8_t size>
+void CIRL_Events<Receiver, size>::process(void)
+{
+    // Handle all new frames with the time they were received
+    while (Receiver::available())
+    {
+        auto data = Receiver::read();
+        frame(data, Receiver::readTime());
+    }
+
+    // Release the button if no more frames are received
+    release(Timebase::now());
+}
+
+
+template<class Receiver, uint8_t size>
+bool CIRL_Events<Receiver, size>::readEvent(IRL_Event_t &event)
+{
+    process();
+    if (mhead == mtail) {
+        return false;
+    }
+    event = mevents[mtail++ % size];
+    return true;
+}
+
+
+template<class Receiver, uint8_t size>
+uint16_t CIRL_Events<Receiver, size>::droppedEvents(void)
+{
+    return mdropped;
+}
+
+
+template<class Receiver, uint8_t size>
+void CIRL_Events<Receiver, size>::frame(const Protocol_data_t &data, uint32_t time)
+{
+    // Events that happened before this frame
+    release(time);
+
+    // Holding frames without a press (after a release) are ignored
+    bool repeat = Traits::repeat(data);
+    if (repeat && !mpressed) {
+        return;
+    }
+    mframeTime = time;
+
+    // Same button is still held down
+    if (mpressed && (repeat || (Traits::same(data, mlast) &&
+                                !Traits::toggled(data, mlast))))
+    {
+        if (mduration < 255) {
+            mduration++;
+        }
+        push(IRL_EVENT_HOLD);
+        return;
+    }
+
+    // Another button was pressed
+    if (mpressed) {
+        push(IRL_EVENT_RELEASE);
+    }
+
+    // Continue the press series with the same button or start a new one
+    if (mcount && Traits::same(data, mlast))
+    {
+        if (mcount < 255) {
+            mcount++;
+        }
+    }
+    else
+    {
+        if (mcount) {
+            push(IRL_EVENT_END);
+        }
+        mcount = 1;
+    }
+
+    mlast = data;
+    mpressed = true;
+    mduration = 1;
+    push(IRL_EVENT_PRESS);
+}
+
+
+template<class Receiver, uint8_t size>
+void CIRL_Events<Receiver, size>::release(uint32_t time)
+{
+    uint32_t duration = time - mframeTime;
+    if (mpressed && duration > releaseTimeout)
+    {
+        push(IRL_EVENT_RELEASE);
+        mpressed = false;
+    }
+    if (mcount && !mpressed && duration > pressTimeout)
+    {
+        push(IRL_EVENT_END);
+        mcount = 0;
+    }
+}
+
+
+template<class Receiver, uint8_t size>
+void CIRL_Events<Receiver, size>::push(IRL_EventType type)
+{
+    // Drop the new event if the queue is full
+    if (uint8_t(mhead - mtail) >= size)
+    {
+        if (mdropped != 0xFFFF) {
+            mdropped++;
+        }
+        return;
+    }
+
+    IRL_Event_t &event = mevents[mhead++ % size];
+    event.type = type;
+    event.count = mcount;
+    event.duration = mduration;
+    event.address = mlast.address;
+    event.command = mlast.command;
+}
@@ -46,6 +46,20 @@ THE SOFTWARE.
 #define FNV_PRIME_32 16777619UL
 #define FNV_BASIS_32 2166136261UL
 
+// Lazy hashing: the interrupt only saves the compared values (2 bit each) and
+// the hash is calculated in available() or read(). The hashes are identical,
+// the interrupt avoids the 32 bit multiplication but needs 64 bytes of RAM.
+// Define before including IRLremote.
+//#define IRL_HASHIR_LAZY
+
+#ifdef IRL_HASHIR_LAZY
+#ifdef IRL_FRAME_QUEUE
+#error "IRL_HASHIR_LAZY can not be used with IRL_FRAME_QUEUE, the queue saves the hash inside the interrupt."
+#endif
+// Every value (0-2) of a comparison uses 2 bit
+#define HASHIR_VALUES_LENGTH ((HASHIR_BLOCKS - 2 + 3) / 4)
+#endif
+
 typedef uint8_t HashIR_address_t;
 typedef uint32_t HashIR_command_t;
 
@@ -60,9 +74,12 @@ struct HashIR_data_t
 // Hash Decoding Class
 //==============================================================================
 
-class CHashIR : public CIRL_Receive<CHashIR>,
-             public CIRL_Time<CHashIR>,
-             public CIRL_Protocol<CHashIR, HashIR_data_t>
+// Each instance number has its own decoding state and interrupt function.
+// Use different numbers (for example the pin number) for multiple receivers.
+template<uint8_t instance>
+class CHashIRInstance : public CIRL_Receive<CHashIRInstance<instance>>,
+             public CIRL_Time<CHashIRInstance<instance>>,
+             public CIRL_Protocol<CHashIRInstance<instance>, HashIR_data_t>
 {
 public:
     // User API to access library data
@@ -72,116 +89,284 @@ public:
 protected:
     static constexpr uint32_t timespanEvent = HashIR_TIMESPAN;
 
-    friend CIRL_Receive<CHashIR>;
-    friend CIRL_Protocol<CHashIR, HashIR_data_t>;
+    friend CIRL_Receive<CHashIRInstance>;
+    friend CIRL_Time<CHashIRInstance>;
+    template<class...> friend class CIRL_Multi;
+    friend CIRL_Protocol<CHashIRInstance, HashIR_data_t>;
 
     // Interrupt function that is attached
-    inline void resetReading(void);
+    static inline void resetReading(void);
     static inline void interrupt(void);
     static constexpr uint8_t interruptMode = CHANGE;
 
+    // Decode the duration of a mark or space
+    static inline void decode(uint16_t duration);
+    static inline void decodeHash(uint16_t duration);
+
+    // Returns x * 3 / 4 (rounded down) without the multiplication. On AVR
+    // x * 3 wraps the 16 bit unsigned int above 21845 ticks, which only the
+    // timer timebases reach. Below the value and the hash are unchanged.
+    static constexpr uint16_t threeQuarters(uint16_t x) {
+        return x - x / 4 - (x % 4 ? 1 : 0);
+    }
+    static inline void event(void);
+#ifdef IRL_HASHIR_LAZY
+    static inline void hashValues(void);
+#endif
+
     // Protocol interface functions
-    inline HashIR_data_t getData(void);
+    static inline HashIR_data_t getData(void);
     static inline bool checksum(void);
     static inline void holding(void);
 
+    // Time values of this instance
+    typedef CIRL_Time<CHashIRInstance> Time;
+    typedef typename Time::Timebase Timebase;
+    using Time::mlastTime;
+    using Time::mlastEvent;
+    using Time::nextTime;
+    using Time::glitch;
+    using Time::timeLimit;
+    using Time::durationLimit;
+    using Time::sequence;
+    using Time::changed;
+#ifdef IRL_FRAME_QUEUE
+    typedef CIRL_Protocol<CHashIRInstance, HashIR_data_t> Protocol;
+    using Protocol::queueFrame;
+    using Protocol::queueAvailable;
+#endif
+#ifdef IRL_DEFERRED_DECODE
+    using Time::capture;
+    using Time::idleTime;
+#endif
+#ifdef IRL_STATISTICS
+    typedef CIRL_Protocol<CHashIRInstance, HashIR_data_t> Statistics;
+    using Statistics::statistic;
+    using Statistics::blocked;
+    using Statistics::mstatistics;
+#endif
+
     // Protocol variables
     static volatile uint8_t count;
     static uint32_t hash;
     static volatile uint16_t lastDuration;
+#ifdef IRL_HASHIR_LAZY
+    static uint8_t values[HASHIR_VALUES_LENGTH];
+    static uint8_t valuesLength;
+#endif
 };
 
+// Default receiver
+typedef CHashIRInstance<0> CHashIR;
+
+
+//==============================================================================
+// Static Data
+//==============================================================================
+
+// Protocol temporary data
+template<uint8_t instance>
+volatile uint8_t CHashIRInstance<instance>::count = 0;
+template<uint8_t instance>
+uint32_t CHashIRInstance<instance>::hash = FNV_BASIS_32;
+template<uint8_t instance>
+volatile uint16_t CHashIRInstance<instance>::lastDuration = 0xFFFF;
+#ifdef IRL_HASHIR_LAZY
+template<uint8_t instance>
+uint8_t CHashIRInstance<instance>::values[HASHIR_VALUES_LENGTH] = { 0 };
+template<uint8_t instance>
+uint8_t CHashIRInstance<instance>::valuesLength = 0;
+#endif
+
 
 //==============================================================================
 // Hash Decoding Implementation
 //==============================================================================
 
-HashIR_data_t CHashIR::getData(void){
+template<uint8_t instance>
+HashIR_data_t CHashIRInstance<instance>::getData(void){
     // Save address as length.
     // You can check the address/length to prevent triggering on noise
     HashIR_data_t retdata;
+#ifdef IRL_HASHIR_LAZY
+    hashValues();
+#endif
     retdata.address = count;
     retdata.command = hash;
     return retdata;
 }
 
 
-bool CHashIR::available(void){
+template<uint8_t instance>
+bool CHashIRInstance<instance>::available(void){
     // First look for a timeout
     receiving();
+#ifdef IRL_FRAME_QUEUE
+    return queueAvailable();
+#else
     bool ret;
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
-    {
+    uint8_t s;
+    do {
+        s = sequence();
         ret = lastDuration == 0;
+    } while (changed(s));
+#ifdef IRL_HASHIR_LAZY
+    // The interrupt is blocked until the data is read,
+    // calculate the hash now and not inside read().
+    if (ret) {
+        hashValues();
     }
+#endif
     return ret;
+#endif
 }
 
 
-void CHashIR::resetReading(void){
+template<uint8_t instance>
+void CHashIRInstance<instance>::resetReading(void){
     // Reset reading
     hash = FNV_BASIS_32;
     lastDuration = 0xFFFF;
     count = 0;
+#ifdef IRL_HASHIR_LAZY
+    valuesLength = 0;
+#endif
 }
 
 
-bool CHashIR::receiving(void)
+template<uint8_t instance>
+bool CHashIRInstance<instance>::receiving(void)
 {
     bool ret = false;
 
-    // Provess with interrupts disabled to avoid any conflicts
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#ifdef IRL_DEFERRED_DECODE
+    // Decoding runs in the main loop, no need to disable interrupts
+    uint32_t timeout = idleTime();
+    if (count != 0 && lastDuration != 0)
     {
-        // Check if we already recognized a timed out
-        if (count == 0) {
-            ret = false;
-        }
-        else
+        // Check for a new timeout
+        if (timeout >= timeLimit(HASHIR_TIMEOUT))
         {
-            // Calculate difference between last interrupt and now
-            uint32_t timeout = mlastTime;
-            uint32_t time = micros();
-            timeout = time - timeout;
+            // Flag new data if we previously received data
+            if(count > 1) {
+                count--;
+                event();
+            }
+            else {
+                count = 0;
+            }
+        }
+        // We are currently receiving
+        else {
+            ret = true;
+        }
+    }
+#else
+    // The last edge may be held back by the glitch filter
+    Time::release();
+
+    // Lock-free snapshot of the decoding state
+    uint8_t s;
+    uint8_t c;
+    uint32_t timeout;
+    do {
+        s = sequence();
+        c = lastDuration != 0 ? count : 0;
+        timeout = mlastTime;
+    } while (changed(s));
+
+    // Check if we already recognized a timed out or a new input
+    if (c != 0)
+    {
+        // Calculate difference between last interrupt and now
+        uint32_t time = Timebase::now();
+        timeout = time - timeout;
 
-            // Check for a new timeout
-            if (timeout >= HASHIR_TIMEOUT)
+        // Check for a new timeout
+        if (timeout >= timeLimit(HASHIR_TIMEOUT))
+        {
+            // Only flag new data if no edge was decoded since the snapshot
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
             {
+                if (changed(s)) {
+                    ret = true;
+                }
                 // Flag new data if we previously received data
-                if(count > 1) {
+                else if(c > 1) {
                     count--;
-                    lastDuration = 0;
-                    mlastEvent = mlastTime;
+                    event();
                 }
                 else {
                     count = 0;
                 }
-                ret = false;
-            }
-            // We are currently receiving
-            else {
-                ret = true;
             }
         }
+        // We are currently receiving
+        else {
+            ret = true;
+        }
     }
+#endif
 
     return ret;
 }
 
 
-void CHashIR::interrupt(void)
+template<uint8_t instance>
+void CHashIRInstance<instance>::interrupt(void)
 {
+#ifdef IRL_DEFERRED_DECODE
+    // Only save the time, decoding is done in the main loop
+    capture();
+#else
+    IRL_PROFILE_START(CHashIRInstance);
+
     // Block if the protocol is already recognized
     if (lastDuration == 0) {
+#ifdef IRL_STATISTICS
+        blocked(Timebase::edge(), timeLimit(HASHIR_TIMEOUT));
+#endif
+        IRL_PROFILE_STOP(CHashIRInstance);
         return;
     }
 
     // Get time between previous call and decode
-    auto duration = nextTime();
+    uint16_t duration = nextTime();
+    if (!glitch(duration)) {
+        decodeHash(duration);
+    }
+    IRL_PROFILE_STOP(CHashIRInstance);
+#endif
+}
+
+
+template<uint8_t instance>
+void CHashIRInstance<instance>::decode(uint16_t duration)
+{
+    IRL_PROFILE_START(CHashIRInstance);
+
+    // Block if the protocol is already recognized
+    if (lastDuration == 0) {
+#ifdef IRL_STATISTICS
+        blocked(mlastTime, timeLimit(HASHIR_TIMEOUT));
+#endif
+        IRL_PROFILE_STOP(CHashIRInstance);
+        return;
+    }
+
+    decodeHash(duration);
+    IRL_PROFILE_STOP(CHashIRInstance);
+}
+
 
+template<uint8_t instance>
+void CHashIRInstance<instance>::decodeHash(uint16_t duration)
+{
     // Reading timed out
-    if(duration >= HASHIR_TIMEOUT)
+    if(duration >= durationLimit(HASHIR_TIMEOUT))
     {
+        IRL_PROFILE_BRANCH(CHashIRInstance, IRL_BRANCH_TIMEOUT);
+
         // Start a new reading sequence.
         if(count == 0) {
             count++;
@@ -189,9 +374,13 @@ void CHashIR::interrupt(void)
         // Ignore the very first timeout of each reading.
         // Otherwise flag a new input and stop reading.
         else if(count != 1) {
+            IRL_PROFILE_BRANCH(CHashIRInstance, IRL_BRANCH_LAST);
             count--;
-            lastDuration = 0;
-            mlastEvent = mlastTime;
+            event();
+#ifdef IRL_FRAME_QUEUE
+            // This timeout also starts the next reading
+            count = 1;
+#endif
         }
         return;
     }
@@ -201,6 +390,8 @@ void CHashIR::interrupt(void)
     // when starting capturing at the middle of a sequence.
     if(count)
     {
+        IRL_PROFILE_BRANCH(CHashIRInstance, IRL_BRANCH_DATA);
+
         // Converts the raw code values into a 32-bit hash code.
         // Hopefully this code is unique for each button.
         // This isn't a "real" decoding, just an arbitrary value.
@@ -217,15 +408,27 @@ void CHashIR::interrupt(void)
             // 1 if newval is equal, and 2 if newval is longer
             // Use a tolerance of 75%
             uint8_t value = 1;
-            if (newval < (oldval * 3 / 4)) {
+            if (newval < threeQuarters(oldval)) {
                 value = 0;
             }
-            else if (oldval < (newval * 3 / 4)) {
+            else if (oldval < threeQuarters(newval)) {
                 value = 2;
             }
 
+#ifdef IRL_HASHIR_LAZY
+            // Save the value, it is added into the hash later
+            uint8_t shift = (valuesLength % 4) * 2;
+            if (shift == 0) {
+                values[valuesLength / 4] = value;
+            }
+            else {
+                values[valuesLength / 4] |= value << shift;
+            }
+            valuesLength++;
+#else
             // Add value into the hash
             hash = (hash * FNV_PRIME_32) ^ value;
+#endif
         }
 
         // Save last time and count up
@@ -233,11 +436,47 @@ void CHashIR::interrupt(void)
 
         // Flag a new input if buffer is full
         if(count >= HASHIR_BLOCKS){
-            lastDuration = 0;
-            mlastEvent = mlastTime;
+            IRL_PROFILE_BRANCH(CHashIRInstance, IRL_BRANCH_LAST);
+            event();
         }
         else {
             lastDuration = duration;
         }
     }
 }
+
+
+/*
+ * Flags a new input and stops reading until it was read.
+ * With a frame queue the input is saved and the reading restarts.
+ */
+template<uint8_t instance>
+void CHashIRInstance<instance>::event(void)
+{
+    IRL_STATISTIC(CHashIRInstance, frames);
+    mlastEvent = mlastTime;
+#ifdef IRL_FRAME_QUEUE
+    queueFrame();
+    resetReading();
+#else
+    lastDuration = 0;
+#endif
+}
+
+
+#ifdef IRL_HASHIR_LAZY
+/*
+ * Adds all saved values into the hash. Only call it if the interrupt is
+ * blocked (new input flagged) or from the main loop with deferred decoding.
+ */
+template<uint8_t instance>
+void CHashIRInstance<instance>::hashValues(void)
+{
+    for (uint8_t i = 0; i < valuesLength; i++)
+    {
+        uint8_t value = (values[i / 4] >> ((i % 4) * 2)) & 0x03;
+        hash = (hash * FNV_PRIME_32) ^ value;
+    }
+    valuesLength = 0;
+}
+#endif
@@ -0,0 +1,174 @@
+/*
+Copyright (c) 2014-2018 NicoHood
+See the readme for credit to other people.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+// Include guard
+#pragma once
+
+#include "IRL_Platform.h"
+#if defined(ARDUINO_ARCH_AVR) || defined(DMBS_ARCH_AVR8)
+#include <avr/pgmspace.h>
+#endif
+
+//==============================================================================
+// Hash Table Definitions
+//==============================================================================
+
+// Returned by lookup() if the hash is not in the table
+#define IRL_HASHTABLE_NONE 0xFFFF
+
+// A learned HashIR code and the action of the sketch
+struct IRL_HashCode_t
+{
+    uint32_t hash;
+    uint16_t action;
+};
+
+//==============================================================================
+// IRL_HashTable Class
+//==============================================================================
+
+// Maps HashIR codes to actions. The codes are saved in PROGMEM, the table
+// object itself only saves pointers and can be constexpr.
+//
+// Sorted table: the codes are sorted by hash, lookup is a binary search.
+// Check the order at compile time with static_assert(CIRL_HashTable::sorted()).
+//
+// Perfect hash table: every code has its own fixed slot, lookup is constant
+// time (a single compare and three flash reads: the seed, the hash and the
+// action of a known hash). The codes and the seeds per bucket are generated
+// with extra/host/HashTable_Gen.cpp.
+class CIRL_HashTable
+{
+public:
+    constexpr CIRL_HashTable(const IRL_HashCode_t* codes, uint16_t length);
+    constexpr CIRL_HashTable(const IRL_HashCode_t* codes, uint16_t length,
+                             const uint16_t* seeds, uint16_t buckets);
+
+    // Returns the action of the hash or IRL_HASHTABLE_NONE
+    inline uint16_t lookup(uint32_t hash) const;
+
+    // Check if a sorted table is valid (strictly increasing hashes)
+    static constexpr bool sorted(const IRL_HashCode_t* codes, uint16_t length);
+
+    // Perfect hash function, shared with the generator
+    static constexpr uint32_t mix(uint32_t hash, uint16_t seed);
+    static constexpr uint16_t slot(uint32_t mixed, uint16_t length);
+
+protected:
+    inline uint16_t search(uint32_t hash) const;
+    inline uint16_t action(uint16_t index, uint32_t hash) const;
+
+    const IRL_HashCode_t* mcodes;
+    const uint16_t* mseeds;
+    uint16_t mlength;
+    uint16_t mbuckets;
+};
+
+
+//==============================================================================
+// CIRL_HashTable Implementation
+//==============================================================================
+
+constexpr CIRL_HashTable::CIRL_HashTable(const IRL_HashCode_t* codes,
+                                         uint16_t length)
+    : mcodes(codes), mseeds(nullptr), mlength(length), mbuckets(0) {}
+
+
+constexpr CIRL_HashTable::CIRL_HashTable(const IRL_HashCode_t* codes,
+                                         uint16_t length,
+                                         const uint16_t* seeds,
+                                         uint16_t buckets)
+    : mcodes(codes), mseeds(seeds), mlength(length), mbuckets(buckets) {}
+
+
+constexpr bool CIRL_HashTable::sorted(const IRL_HashCode_t* codes,
+                                      uint16_t length) {
+    // Split in halves to keep the recursion depth low for large tables
+    return length < 2 ? true :
+           sorted(codes, length / 2) &&
+           codes[length / 2 - 1].hash < codes[length / 2].hash &&
+           sorted(codes + length / 2, length - length / 2);
+}
+
+
+constexpr uint32_t CIRL_HashTable::mix(uint32_t hash, uint16_t seed) {
+    // Multiplicative hashing (Knuth), the upper bits are mixed best
+    return (uint32_t)((hash ^ seed) * 2654435761UL);
+}
+
+
+constexpr uint16_t CIRL_HashTable::slot(uint32_t mixed, uint16_t length) {
+    // Maps the upper 16 bit to 0..length-1 without a division
+    return ((mixed >> 16) * length) >> 16;
+}
+
+
+uint16_t CIRL_HashTable::lookup(uint32_t hash) const
+{
+    if (!mlength) {
+        return IRL_HASHTABLE_NONE;
+    }
+
+    // Sorted table
+    if (!mseeds) {
+        return search(hash);
+    }
+
+    // Perfect hash table: the bucket seed moves the hash to its slot
+    uint16_t bucket = slot(mix(hash, 0), mbuckets);
+    uint16_t seed = pgm_read_word(&mseeds[bucket]);
+    return action(slot(mix(hash, seed), mlength), hash);
+}
+
+
+uint16_t CIRL_HashTable::search(uint32_t hash) const
+{
+    uint16_t first = 0;
+    uint16_t last = mlength;
+    while (first < last)
+    {
+        uint16_t middle = first + (last - first) / 2;
+        uint32_t value = pgm_read_dword(&mcodes[middle].hash);
+        if (value == hash) {
+            return pgm_read_word(&mcodes[middle].action);
+        }
+        if (value < hash) {
+            first = middle + 1;
+        }
+        else {
+            last = middle;
+        }
+    }
+    return IRL_HASHTABLE_NONE;
+}
+
+
+uint16_t CIRL_HashTable::action(uint16_t index, uint32_t hash) const
+{
+    // Unknown hashes also map to a slot, compare the saved hash
+    if (pgm_read_dword(&mcodes[index].hash) != hash) {
+        return IRL_HASHTABLE_NONE;
+    }
+    return pgm_read_word(&mcodes[index].action);
+}
@@ -0,0 +1,338 @@
+/*
+Copyright (c) 2014-2018 NicoHood
+See the readme for credit to other people.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+// Include guard
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+//==============================================================================
+// Host Platform Definitions
+//==============================================================================
+
+// Arduino compatible constants used by the receive and decode classes
+#define LOW                 0x0
+#define HIGH                0x1
+#define INPUT               0x0
+#define OUTPUT              0x1
+#define INPUT_PULLUP        0x2
+#define CHANGE              1
+#define FALLING             2
+#define RISING              3
+#define NOT_AN_INTERRUPT    -1
+
+// Number of simulated pins. Every pin is a valid PinInterrupt pin.
+#ifndef IRL_HOST_PINS
+#define IRL_HOST_PINS       32
+#endif
+
+// Number of recorded sender output changes
+#ifndef IRL_HOST_TIMELINE
+#define IRL_HOST_TIMELINE   256
+#endif
+
+// Interrupts are simulated synchronously in the thread that drives the pins,
+// so there is nothing that an atomic block has to protect against.
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+#define ATOMIC_BLOCK(type) \
+    for (uint8_t _irl_done = 1; _irl_done; _irl_done = 0)
+
+typedef void(*IRL_HostInterrupt)(void);
+
+//==============================================================================
+// IRL_Host Class
+//==============================================================================
+
+class CIRL_Host
+{
+public:
+    // Virtual clock that replaces the hardware micros() counter
+    static inline uint32_t micros(void);
+    static inline void setMicros(uint32_t time);
+    static inline void advance(uint32_t duration);
+
+    // Interrupt attach hooks used by CIRL_Receive::begin/end
+    static inline void attach(uint8_t interrupt, IRL_HostInterrupt isr,
+                              uint8_t mode);
+    static inline void detach(uint8_t interrupt);
+
+    // Drive a pin. Attached interrupts fire on matching edges.
+    static inline void write(uint8_t pin, uint8_t level);
+    static inline uint8_t read(uint8_t pin);
+
+    // IR receivers are active low: a mark pulls the pin low for duration
+    static inline void mark(uint8_t pin, uint16_t duration);
+    static inline void space(uint8_t pin, uint32_t duration);
+
+    // One shot timer interrupt, called by advance() at the given time
+    static inline void timer(uint32_t time, IRL_HostInterrupt isr);
+    static inline uint32_t timerTime(void);
+    static inline void stopTimer(void);
+
+    // Sender output, true while the carrier is on. Every change is recorded.
+    // Marks are also written to the loopback pin (active low like a receiver).
+    static inline void output(bool carrier);
+    static inline void loopback(uint8_t pin);
+    static inline void setFrequency(uint32_t hz);
+    static inline uint32_t frequency(void);
+
+    // Recorded timeline of the sender output
+    static inline uint16_t timelineLength(void);
+    static inline uint32_t timelineTime(uint16_t index);
+    static inline bool timelineCarrier(uint16_t index);
+    static inline void clearTimeline(void);
+
+    // Reset clock, pins, attached interrupts, timer and timeline
+    static inline void reset(void);
+
+protected:
+    static uint32_t mtime;
+    static uint8_t mlevel[IRL_HOST_PINS];
+    static uint8_t mmode[IRL_HOST_PINS];
+    static IRL_HostInterrupt misr[IRL_HOST_PINS];
+
+    static uint32_t mtimerTime;
+    static IRL_HostInterrupt mtimerIsr;
+
+    static bool mcarrier;
+    static uint8_t mloopback;
+    static uint32_t mfrequency;
+    static uint32_t mtimelineTime[IRL_HOST_TIMELINE];
+    static bool mtimelineCarrier[IRL_HOST_TIMELINE];
+    static uint16_t mtimelineLength;
+};
+
+
+//==============================================================================
+// Arduino API
+//==============================================================================
+
+static inline uint32_t micros(void) {
+    return CIRL_Host::micros();
+}
+
+static inline int digitalPinToInterrupt(uint8_t pin) {
+    return pin < IRL_HOST_PINS ? pin : NOT_AN_INTERRUPT;
+}
+
+static inline void pinMode(uint8_t pin, uint8_t mode) {
+    // An input with pullup idles high, like a connected IR receiver
+    if (mode == INPUT_PULLUP && pin < IRL_HOST_PINS) {
+        CIRL_Host::write(pin, HIGH);
+    }
+}
+
+static inline int digitalRead(uint8_t pin) {
+    return CIRL_Host::read(pin);
+}
+
+static inline void attachInterrupt(uint8_t interrupt, IRL_HostInterrupt isr,
+                                   int mode) {
+    CIRL_Host::attach(interrupt, isr, mode);
+}
+
+static inline void detachInterrupt(uint8_t interrupt) {
+    CIRL_Host::detach(interrupt);
+}
+
+// Flash is normal memory on the host
+#define PROGMEM
+#define pgm_read_byte(addr)  (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr)   (*(const void * const *)(addr))
+
+
+//==============================================================================
+// CIRL_Host Implementation
+//==============================================================================
+
+uint32_t CIRL_Host::micros(void) {
+    return mtime;
+}
+
+
+void CIRL_Host::setMicros(uint32_t time) {
+    mtime = time;
+}
+
+
+void CIRL_Host::advance(uint32_t duration)
+{
+    // Call the timer interrupt if it is due, it might start the timer again
+    uint32_t time = mtime + duration;
+    while (mtimerIsr && int32_t(time - mtimerTime) >= 0)
+    {
+        auto isr = mtimerIsr;
+        mtimerIsr = nullptr;
+        mtime = mtimerTime;
+        isr();
+    }
+
+    // Overflows like the hardware counter does
+    mtime = time;
+}
+
+
+void CIRL_Host::attach(uint8_t interrupt, IRL_HostInterrupt isr, uint8_t mode)
+{
+    if (interrupt < IRL_HOST_PINS) {
+        misr[interrupt] = isr;
+        mmode[interrupt] = mode;
+    }
+}
+
+
+void CIRL_Host::detach(uint8_t interrupt)
+{
+    if (interrupt < IRL_HOST_PINS) {
+        misr[interrupt] = nullptr;
+    }
+}
+
+
+void CIRL_Host::write(uint8_t pin, uint8_t level)
+{
+    if (pin >= IRL_HOST_PINS || mlevel[pin] == level) {
+        return;
+    }
+    mlevel[pin] = level;
+
+    // Call the attached interrupt if the edge matches its mode
+    auto isr = misr[pin];
+    if (!isr) {
+        return;
+    }
+    auto mode = mmode[pin];
+    if (mode == CHANGE || (mode == FALLING && level == LOW) ||
+        (mode == RISING && level == HIGH)) {
+        isr();
+    }
+}
+
+
+uint8_t CIRL_Host::read(uint8_t pin) {
+    return pin < IRL_HOST_PINS ? mlevel[pin] : LOW;
+}
+
+
+void CIRL_Host::mark(uint8_t pin, uint16_t duration)
+{
+    write(pin, LOW);
+    advance(duration);
+}
+
+
+void CIRL_Host::space(uint8_t pin, uint32_t duration)
+{
+    write(pin, HIGH);
+    advance(duration);
+}
+
+
+void CIRL_Host::timer(uint32_t time, IRL_HostInterrupt isr)
+{
+    mtimerTime = time;
+    mtimerIsr = isr;
+}
+
+
+uint32_t CIRL_Host::timerTime(void) {
+    return mtimerTime;
+}
+
+
+void CIRL_Host::stopTimer(void) {
+    mtimerIsr = nullptr;
+}
+
+
+void CIRL_Host::output(bool carrier)
+{
+    if (carrier == mcarrier) {
+        return;
+    }
+    mcarrier = carrier;
+
+    if (mtimelineLength < IRL_HOST_TIMELINE)
+    {
+        mtimelineTime[mtimelineLength] = mtime;
+        mtimelineCarrier[mtimelineLength] = carrier;
+        mtimelineLength++;
+    }
+
+    write(mloopback, carrier ? LOW : HIGH);
+}
+
+
+void CIRL_Host::loopback(uint8_t pin) {
+    mloopback = pin;
+}
+
+
+void CIRL_Host::setFrequency(uint32_t hz) {
+    mfrequency = hz;
+}
+
+
+uint32_t CIRL_Host::frequency(void) {
+    return mfrequency;
+}
+
+
+uint16_t CIRL_Host::timelineLength(void) {
+    return mtimelineLength;
+}
+
+
+uint32_t CIRL_Host::timelineTime(uint16_t index) {
+    return mtimelineTime[index];
+}
+
+
+bool CIRL_Host::timelineCarrier(uint16_t index) {
+    return mtimelineCarrier[index];
+}
+
+
+void CIRL_Host::clearTimeline(void) {
+    mtimelineLength = 0;
+}
+
+
+void CIRL_Host::reset(void)
+{
+    mtime = 0;
+    mtimerIsr = nullptr;
+    mcarrier = false;
+    mloopback = 0xFF;
+    mtimelineLength = 0;
+    for (uint8_t i = 0; i < IRL_HOST_PINS; i++) {
+        mlevel[i] = HIGH;
+        mmode[i] = 0;
+        misr[i] = nullptr;
+    }
+}
@@ -0,0 +1,638 @@
+/*
+Copyright (c) 2014-2018 NicoHood
+See the readme for credit to other people.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Include guard
+#pragma once
+
+#include "IRL_Platform.h"
+
+//==============================================================================
+// IRL_IRP Class
+//==============================================================================
+
+/*
+ * Compile time parser for the IRP notation. All functions are constexpr,
+ * the timings and decoding limits of a protocol are calculated by the
+ * compiler from a single IRP string:
+ *
+ * {38.4k,564}<1,-1|1,-3>(16,-8,D:8,S:8,F:8,~F:8,1,-78,(16,-4,1,-173)*)
+ * |         ||         ||                                           |
+ *   General    Bitspec   Bitstream with an optional holding frame
+ *
+ * General spec: frequency (k suffix), unit (us, optional u suffix), msb/lsb.
+ * Bitspec: the durations of 0 and 1, in units. Negative values are spaces.
+ * Bitstream: durations (units, or us/ms with a u/m suffix), fields
+ * (name or expression:bits[:offset]), an extent (^45m), a nested bitspec
+ * with a stream (<...>(...)) or a repeated stream ((...)* or (...)+).
+ * The bitstream may be followed by * or +.
+ *
+ * valid() checks this syntax. spaces() checks the subset that
+ * CIRL_DecodeSpaces and the sender handle: lead mark/space, fields,
+ * end mark, trailing space and an optional holding frame (m,-s,m,-s)*,
+ * two durations per bit (mark, space) and LSB first data.
+ */
+
+// Timings of a protocol in microseconds
+struct IRL_Timing_t
+{
+    uint32_t hz;
+    uint16_t markLead;
+    uint16_t spaceLead;
+    uint16_t markHolding;
+    uint16_t spaceHolding;
+    uint16_t markZero;
+    uint16_t spaceZero;
+    uint16_t markOne;
+    uint16_t spaceOne;
+    uint16_t markEnd;
+    uint32_t spaceEnd;
+    uint32_t spaceEndHolding;
+    uint8_t bits;
+    uint16_t unit;
+    // Time from frame start to frame start (^), zero for a fixed gap
+    uint32_t extent;
+};
+
+class CIRL_IRP
+{
+public:
+    // Syntax check and the check for lead + space protocols
+    static constexpr bool valid(const char* irp);
+    static constexpr bool spaces(const char* irp);
+
+    // General spec
+    static constexpr uint32_t frequency(const char* irp);
+    static constexpr uint16_t unit(const char* irp);
+    static constexpr bool msb(const char* irp);
+
+    // Timings of the bitspec and bitstream
+    static constexpr IRL_Timing_t timing(const char* irp);
+
+    // Values of the timings
+    static constexpr uint8_t blocks(const IRL_Timing_t &t);
+    static constexpr uint8_t length(const IRL_Timing_t &t);
+    static constexpr bool holding(const IRL_Timing_t &t);
+    static constexpr uint32_t logicalLead(const IRL_Timing_t &t);
+    static constexpr uint32_t logicalHolding(const IRL_Timing_t &t);
+    static constexpr uint32_t logicalZero(const IRL_Timing_t &t);
+    static constexpr uint32_t logicalOne(const IRL_Timing_t &t);
+    static constexpr uint32_t timespanHolding(const IRL_Timing_t &t);
+
+    // Decoding limits for CIRL_DecodeSpaces (midpoints between timings)
+    static constexpr uint32_t limitLogic(const IRL_Timing_t &t);
+    static constexpr uint32_t limitHolding(const IRL_Timing_t &t);
+    static constexpr uint32_t limitLead(const IRL_Timing_t &t);
+    static constexpr uint32_t limitTimeout(const IRL_Timing_t &t);
+    static constexpr uint32_t limitRepeat(const IRL_Timing_t &t);
+
+    // Write the durations of a frame (LSB first data) or a holding frame.
+    // The trailing space is not included. Returns the number of durations.
+    static inline uint8_t encode(const IRL_Timing_t &timing,
+                                 const uint8_t* data, uint16_t* durations);
+    static inline uint8_t encodeHolding(const IRL_Timing_t &timing,
+                                        uint16_t* durations);
+
+protected:
+    // Characters and numbers
+    static constexpr bool digit(char c);
+    static constexpr bool separator(char c);
+    static constexpr size_t digits(const char* irp, size_t i);
+    static constexpr uint32_t integer(const char* irp, size_t i,
+                                      uint32_t value);
+    static constexpr uint32_t decimal(const char* irp, size_t i,
+                                      uint32_t value, uint32_t divisor,
+                                      bool point);
+
+    // Groups ({}, <>, ()) and their comma separated items
+    static constexpr size_t closing(const char* irp, size_t i, uint8_t depth);
+    static constexpr size_t skipGroup(const char* irp, size_t i);
+    static constexpr size_t itemEnd(const char* irp, size_t i);
+    static constexpr size_t item(const char* irp, size_t i, uint8_t n);
+    static constexpr size_t groupEnd(const char* irp, size_t i);
+    static constexpr size_t lastItem(const char* irp, size_t i);
+
+    // Item types: '+' mark, '-' space, 'e' extent, 'f' field,
+    // 'r' repeated stream, 'b' nested bitspec, 'x' none, '?' invalid
+    static constexpr bool isDuration(const char* irp, size_t i);
+    static constexpr size_t colon(const char* irp, size_t i);
+    static constexpr bool isField(const char* irp, size_t i);
+    static constexpr char kind(const char* irp, size_t i);
+    static constexpr char general(const char* irp, size_t i);
+    static constexpr uint32_t micros(const char* irp, size_t i, uint16_t unit);
+
+    // Sections
+    static constexpr size_t posBitspec(const char* irp);
+    static constexpr size_t posOne(const char* irp);
+    static constexpr size_t posStream(const char* irp);
+    static constexpr size_t posRepeat(const char* irp);
+    static constexpr size_t findGeneral(const char* irp, size_t i, char k);
+
+    // Syntax checks
+    static constexpr bool validGeneral(const char* irp, size_t i);
+    static constexpr bool validDurations(const char* irp, size_t i, char end);
+    static constexpr bool validStream(const char* irp, size_t i);
+    static constexpr bool validPair(const char* irp, size_t i);
+    static constexpr bool validHolding(const char* irp, size_t i);
+
+    // Bitstream layout: index of the first item after the fields,
+    // sum of the field lengths
+    static constexpr uint8_t fieldsEnd(const char* irp, size_t s, uint8_t n);
+    static constexpr uint8_t sumBits(const char* irp, size_t s, uint8_t n,
+                                     uint8_t end);
+    static constexpr uint8_t posGap(const char* irp, size_t s, uint8_t k);
+    static constexpr uint32_t value(const char* irp, size_t i, char k,
+                                    uint16_t unit);
+    static constexpr IRL_Timing_t timing(const char* irp, size_t s, uint8_t k,
+                                         uint8_t gap, uint16_t unit);
+};
+
+// Decoding constants of a lead + space protocol for CIRL_DecodeSpaces,
+// generated from the timings of its IRP notation
+#define IRL_IRP_SPACES(irp) \
+    static_assert(CIRL_IRP::spaces(irp), \
+                  "Unsupported IRP notation: " irp); \
+    static constexpr uint32_t timespanEvent = CIRL_IRP::timespanHolding(CIRL_IRP::timing(irp)); \
+    static constexpr uint32_t limitTimeout = CIRL_IRP::limitTimeout(CIRL_IRP::timing(irp)); \
+    static constexpr uint32_t limitLead = CIRL_IRP::limitLead(CIRL_IRP::timing(irp)); \
+    static constexpr uint32_t limitHolding = CIRL_IRP::limitHolding(CIRL_IRP::timing(irp)); \
+    static constexpr uint32_t limitLogic = CIRL_IRP::limitLogic(CIRL_IRP::timing(irp)); \
+    static constexpr uint32_t limitRepeat = CIRL_IRP::limitRepeat(CIRL_IRP::timing(irp)); \
+    static constexpr uint32_t logicalLead = CIRL_IRP::logicalLead(CIRL_IRP::timing(irp)); \
+    static constexpr uint8_t irLength = CIRL_IRP::length(CIRL_IRP::timing(irp))
+
+
+//==============================================================================
+// CIRL_IRP Helpers
+//==============================================================================
+
+constexpr bool CIRL_IRP::digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+
+constexpr bool CIRL_IRP::separator(char c) {
+    return c == ',' || c == '|' || c == ')' || c == '>' || c == '}' ||
+           c == '\0';
+}
+
+
+// Index after the digits at i
+constexpr size_t CIRL_IRP::digits(const char* irp, size_t i) {
+    return digit(irp[i]) ? digits(irp, i + 1) : i;
+}
+
+
+constexpr uint32_t CIRL_IRP::integer(const char* irp, size_t i,
+                                     uint32_t value) {
+    return digit(irp[i]) ?
+           integer(irp, i + 1, value * 10 + (irp[i] - '0')) : value;
+}
+
+
+// Decimal number with optional k (kilo) suffix, for example 38.4k
+constexpr uint32_t CIRL_IRP::decimal(const char* irp, size_t i,
+                                     uint32_t value, uint32_t divisor,
+                                     bool point) {
+    return digit(irp[i]) ?
+               decimal(irp, i + 1, value * 10 + (irp[i] - '0'),
+                       point ? divisor * 10 : divisor, point) :
+           irp[i] == '.' ? decimal(irp, i + 1, value, divisor, true) :
+           irp[i] == 'k' ? value * 1000UL / divisor : value / divisor;
+}
+
+
+// Index of the bracket that closes the group, or of the string end
+constexpr size_t CIRL_IRP::closing(const char* irp, size_t i, uint8_t depth) {
+    return irp[i] == '\0' ? i :
+           (irp[i] == '{' || irp[i] == '<' || irp[i] == '(') ?
+               closing(irp, i + 1, depth + 1) :
+           (irp[i] == '}' || irp[i] == '>' || irp[i] == ')') ?
+               (depth == 1 ? i : closing(irp, i + 1, depth - 1)) :
+           closing(irp, i + 1, depth);
+}
+
+
+// Index after the group that starts at i
+constexpr size_t CIRL_IRP::skipGroup(const char* irp, size_t i) {
+    return irp[closing(irp, i + 1, 1)] == '\0' ? closing(irp, i + 1, 1) :
+           closing(irp, i + 1, 1) + 1;
+}
+
+
+// Index of the separator after the item at i, nested groups are skipped
+constexpr size_t CIRL_IRP::itemEnd(const char* irp, size_t i) {
+    return separator(irp[i]) ? i :
+           (irp[i] == '(' || irp[i] == '<') ? itemEnd(irp, skipGroup(irp, i)) :
+           itemEnd(irp, i + 1);
+}
+
+
+// Index of the n-th item from i, or of the separator that ends the group
+constexpr size_t CIRL_IRP::item(const char* irp, size_t i, uint8_t n) {
+    return n == 0 ? i :
+           irp[itemEnd(irp, i)] == ',' ? item(irp, itemEnd(irp, i) + 1, n - 1) :
+           itemEnd(irp, i);
+}
+
+
+// Index of the separator after the last item of a group
+constexpr size_t CIRL_IRP::groupEnd(const char* irp, size_t i) {
+    return irp[itemEnd(irp, i)] == ',' ? groupEnd(irp, itemEnd(irp, i) + 1) :
+           itemEnd(irp, i);
+}
+
+
+// Index of the last item of a group
+constexpr size_t CIRL_IRP::lastItem(const char* irp, size_t i) {
+    return irp[itemEnd(irp, i)] == ',' ? lastItem(irp, itemEnd(irp, i) + 1) : i;
+}
+
+
+// Number with optional sign and u/m suffix
+constexpr bool CIRL_IRP::isDuration(const char* irp, size_t i) {
+    return irp[i] == '-' ? isDuration(irp, i + 1) :
+           digit(irp[i]) &&
+           (separator(irp[digits(irp, i)]) ||
+            ((irp[digits(irp, i)] == 'u' || irp[digits(irp, i)] == 'm') &&
+             separator(irp[digits(irp, i) + 1])));
+}
+
+
+// Index of the colon of a field, or of the separator after the item
+constexpr size_t CIRL_IRP::colon(const char* irp, size_t i) {
+    return (irp[i] == ':' || separator(irp[i])) ? i :
+           irp[i] == '(' ? colon(irp, skipGroup(irp, i)) :
+           colon(irp, i + 1);
+}
+
+
+// Name or expression, followed by :bits and an optional :offset
+constexpr bool CIRL_IRP::isField(const char* irp, size_t i) {
+    return irp[colon(irp, i)] == ':' && colon(irp, i) > i &&
+           digits(irp, colon(irp, i) + 1) > colon(irp, i) + 1 &&
+           (separator(irp[digits(irp, colon(irp, i) + 1)]) ||
+            (irp[digits(irp, colon(irp, i) + 1)] == ':' &&
+             digit(irp[digits(irp, colon(irp, i) + 1) + 1]) &&
+             separator(irp[digits(irp, digits(irp, colon(irp, i) + 1) + 1)])));
+}
+
+
+constexpr char CIRL_IRP::kind(const char* irp, size_t i) {
+    return separator(irp[i]) ? 'x' :
+           isDuration(irp, i) ? (irp[i] == '-' ? '-' : '+') :
+           (irp[i] == '^' && digit(irp[i + 1]) && isDuration(irp, i + 1)) ? 'e' :
+           (irp[i] == '(' &&
+            (irp[skipGroup(irp, i)] == '*' || irp[skipGroup(irp, i)] == '+') &&
+            separator(irp[skipGroup(irp, i) + 1])) ? 'r' :
+           (irp[i] == '<' && irp[skipGroup(irp, i)] == '(' &&
+            separator(irp[skipGroup(irp, skipGroup(irp, i))])) ? 'b' :
+           isField(irp, i) ? 'f' : '?';
+}
+
+
+// General spec items: 'f' frequency, 'u' unit, 'm' msb, 'l' lsb
+constexpr char CIRL_IRP::general(const char* irp, size_t i) {
+    return (irp[i] == 'm' && irp[i + 1] == 's' && irp[i + 2] == 'b' &&
+            separator(irp[i + 3])) ? 'm' :
+           (irp[i] == 'l' && irp[i + 1] == 's' && irp[i + 2] == 'b' &&
+            separator(irp[i + 3])) ? 'l' :
+           !digit(irp[i]) ? '?' :
+           (irp[digits(irp, i)] == '.' && digit(irp[digits(irp, i) + 1]) &&
+            irp[digits(irp, digits(irp, i) + 1)] == 'k' &&
+            separator(irp[digits(irp, digits(irp, i) + 1) + 1])) ? 'f' :
+           (irp[digits(irp, i)] == 'k' && separator(irp[digits(irp, i) + 1])) ? 'f' :
+           (separator(irp[digits(irp, i)]) ||
+            (irp[digits(irp, i)] == 'u' && separator(irp[digits(irp, i) + 1]))) ?
+               'u' : '?';
+}
+
+
+// Duration or extent in microseconds
+constexpr uint32_t CIRL_IRP::micros(const char* irp, size_t i, uint16_t unit) {
+    return (irp[i] == '-' || irp[i] == '^') ? micros(irp, i + 1, unit) :
+           irp[digits(irp, i)] == 'm' ? integer(irp, i, 0) * 1000UL :
+           irp[digits(irp, i)] == 'u' ? integer(irp, i, 0) :
+           integer(irp, i, 0) * unit;
+}
+
+
+constexpr size_t CIRL_IRP::posBitspec(const char* irp) {
+    return skipGroup(irp, 0);
+}
+
+
+// Durations of a one bit, after the |
+constexpr size_t CIRL_IRP::posOne(const char* irp) {
+    return groupEnd(irp, posBitspec(irp) + 1) + 1;
+}
+
+
+constexpr size_t CIRL_IRP::posStream(const char* irp) {
+    return skipGroup(irp, posBitspec(irp));
+}
+
+
+constexpr size_t CIRL_IRP::posRepeat(const char* irp) {
+    return skipGroup(irp, posStream(irp));
+}
+
+
+// Index of the first general spec item of a type, zero if there is none
+constexpr size_t CIRL_IRP::findGeneral(const char* irp, size_t i, char k) {
+    return general(irp, i) == k ? i :
+           irp[itemEnd(irp, i)] == ',' ? findGeneral(irp, itemEnd(irp, i) + 1, k) :
+           0;
+}
+
+
+//==============================================================================
+// CIRL_IRP Syntax
+//==============================================================================
+
+constexpr bool CIRL_IRP::validGeneral(const char* irp, size_t i) {
+    return general(irp, i) != '?' &&
+           (irp[itemEnd(irp, i)] == ',' ? validGeneral(irp, itemEnd(irp, i) + 1) :
+            irp[itemEnd(irp, i)] == '}');
+}
+
+
+constexpr bool CIRL_IRP::validDurations(const char* irp, size_t i, char end) {
+    return isDuration(irp, i) &&
+           (irp[itemEnd(irp, i)] == ',' ?
+                validDurations(irp, itemEnd(irp, i) + 1, end) :
+            irp[itemEnd(irp, i)] == end);
+}
+
+
+// Nested streams are checked as well
+constexpr bool CIRL_IRP::validStream(const char* irp, size_t i) {
+    return kind(irp, i) != '?' && kind(irp, i) != 'x' &&
+           (kind(irp, i) != 'r' || validStream(irp, i + 1)) &&
+           (kind(irp, i) != 'b' ||
+            (validDurations(irp, i + 1, '|') &&
+             validDurations(irp, groupEnd(irp, i + 1) + 1, '>') &&
+             validStream(irp, skipGroup(irp, i) + 1))) &&
+           (irp[itemEnd(irp, i)] == ',' ? validStream(irp, itemEnd(irp, i) + 1) :
+            irp[itemEnd(irp, i)] == ')');
+}
+
+
+constexpr bool CIRL_IRP::valid(const char* irp) {
+    return irp[0] == '{' && validGeneral(irp, 1) &&
+           irp[posBitspec(irp)] == '<' &&
+           validDurations(irp, posBitspec(irp) + 1, '|') &&
+           validDurations(irp, posOne(irp), '>') &&
+           irp[posStream(irp)] == '(' && validStream(irp, posStream(irp) + 1) &&
+           (irp[posRepeat(irp)] == '\0' ||
+            ((irp[posRepeat(irp)] == '*' || irp[posRepeat(irp)] == '+') &&
+             irp[posRepeat(irp) + 1] == '\0'));
+}
+
+
+// Mark followed by a space
+constexpr bool CIRL_IRP::validPair(const char* irp, size_t i) {
+    return kind(irp, item(irp, i, 0)) == '+' &&
+           kind(irp, item(irp, i, 1)) == '-' &&
+           kind(irp, item(irp, i, 2)) == 'x';
+}
+
+
+// Holding frame (mark, space, end mark, space)*
+constexpr bool CIRL_IRP::validHolding(const char* irp, size_t i) {
+    return irp[skipGroup(irp, i) ] == '*' &&
+           kind(irp, item(irp, i + 1, 0)) == '+' &&
+           kind(irp, item(irp, i + 1, 1)) == '-' &&
+           kind(irp, item(irp, i + 1, 2)) == '+' &&
+           kind(irp, item(irp, i + 1, 3)) == '-' &&
+           kind(irp, item(irp, i + 1, 4)) == 'x';
+}
+
+
+constexpr bool CIRL_IRP::spaces(const char* irp) {
+    return valid(irp) && !msb(irp) &&
+           validPair(irp, posBitspec(irp) + 1) && validPair(irp, posOne(irp)) &&
+           kind(irp, item(irp, posStream(irp) + 1, 0)) == '+' &&
+           kind(irp, item(irp, posStream(irp) + 1, 1)) == '-' &&
+           fieldsEnd(irp, posStream(irp) + 1, 2) > 2 &&
+           kind(irp, item(irp, posStream(irp) + 1,
+                          fieldsEnd(irp, posStream(irp) + 1, 2))) == '+' &&
+           kind(irp, item(irp, posStream(irp) + 1,
+                          fieldsEnd(irp, posStream(irp) + 1, 2) + 1)) == '-' &&
+           // Either a holding frame and no repeat, or just repeats
+           (kind(irp, item(irp, posStream(irp) + 1,
+                           fieldsEnd(irp, posStream(irp) + 1, 2) + 2)) == 'r' ?
+                validHolding(irp, item(irp, posStream(irp) + 1,
+                                       fieldsEnd(irp, posStream(irp) + 1, 2) + 2)) &&
+                kind(irp, item(irp, posStream(irp) + 1,
+                               fieldsEnd(irp, posStream(irp) + 1, 2) + 3)) == 'x' &&
+                irp[posRepeat(irp)] == '\0' :
+            kind(irp, item(irp, posStream(irp) + 1,
+                           fieldsEnd(irp, posStream(irp) + 1, 2) + 2)) == 'x');
+}
+
+
+//==============================================================================
+// CIRL_IRP Implementation
+//==============================================================================
+
+// Default 38kHz
+constexpr uint32_t CIRL_IRP::frequency(const char* irp) {
+    return findGeneral(irp, 1, 'f') ?
+           decimal(irp, findGeneral(irp, 1, 'f'), 0, 1, false) : 38000UL;
+}
+
+
+// Default 1us
+constexpr uint16_t CIRL_IRP::unit(const char* irp) {
+    return findGeneral(irp, 1, 'u') ? integer(irp, findGeneral(irp, 1, 'u'), 0) : 1;
+}
+
+
+constexpr bool CIRL_IRP::msb(const char* irp) {
+    return findGeneral(irp, 1, 'm') != 0;
+}
+
+
+constexpr uint8_t CIRL_IRP::fieldsEnd(const char* irp, size_t s, uint8_t n) {
+    return kind(irp, item(irp, s, n)) == 'f' ? fieldsEnd(irp, s, n + 1) : n;
+}
+
+
+constexpr uint8_t CIRL_IRP::sumBits(const char* irp, size_t s, uint8_t n,
+                                    uint8_t end) {
+    return n >= end ? 0 :
+           integer(irp, colon(irp, item(irp, s, n)) + 1, 0) +
+           sumBits(irp, s, n + 1, end);
+}
+
+
+// The end mark is optional if the frame has an extent
+constexpr uint8_t CIRL_IRP::posGap(const char* irp, size_t s, uint8_t k) {
+    return kind(irp, item(irp, s, k)) == '+' ? k + 1 : k;
+}
+
+
+// Duration of an item of the expected type, else zero
+constexpr uint32_t CIRL_IRP::value(const char* irp, size_t i, char k,
+                                   uint16_t unit) {
+    return kind(irp, i) == k ? micros(irp, i, unit) : 0;
+}
+
+
+constexpr IRL_Timing_t CIRL_IRP::timing(const char* irp, size_t s, uint8_t k,
+                                        uint8_t gap, uint16_t unit) {
+    return IRL_Timing_t{
+        frequency(irp),
+        uint16_t(value(irp, item(irp, s, 0), '+', unit)),
+        uint16_t(value(irp, item(irp, s, 1), '-', unit)),
+        uint16_t(kind(irp, item(irp, s, gap + 1)) == 'r' ?
+                 value(irp, item(irp, item(irp, s, gap + 1) + 1, 0), '+', unit) : 0),
+        uint16_t(kind(irp, item(irp, s, gap + 1)) == 'r' ?
+                 value(irp, item(irp, item(irp, s, gap + 1) + 1, 1), '-', unit) : 0),
+        uint16_t(value(irp, item(irp, posBitspec(irp) + 1, 0), '+', unit)),
+        uint16_t(value(irp, item(irp, posBitspec(irp) + 1, 1), '-', unit)),
+        uint16_t(value(irp, item(irp, posOne(irp), 0), '+', unit)),
+        uint16_t(value(irp, item(irp, posOne(irp), 1), '-', unit)),
+        uint16_t(gap > k ? value(irp, item(irp, s, k), '+', unit) : 0),
+        value(irp, item(irp, s, gap), '-', unit),
+        kind(irp, item(irp, s, gap + 1)) == 'r' ?
+            value(irp, item(irp, item(irp, s, gap + 1) + 1, 3), '-', unit) : 0,
+        sumBits(irp, s, 2, k),
+        unit,
+        value(irp, lastItem(irp, s), 'e', unit)
+    };
+}
+
+
+constexpr IRL_Timing_t CIRL_IRP::timing(const char* irp) {
+    return timing(irp, posStream(irp) + 1, fieldsEnd(irp, posStream(irp) + 1, 2),
+                  posGap(irp, posStream(irp) + 1,
+                         fieldsEnd(irp, posStream(irp) + 1, 2)),
+                  unit(irp));
+}
+
+
+constexpr uint8_t CIRL_IRP::blocks(const IRL_Timing_t &t) {
+    return t.bits / 8;
+}
+
+
+// 2 for lead + space, each bit has mark and space
+constexpr uint8_t CIRL_IRP::length(const IRL_Timing_t &t) {
+    return 2 + t.bits * 2;
+}
+
+
+constexpr bool CIRL_IRP::holding(const IRL_Timing_t &t) {
+    return t.markHolding != 0;
+}
+
+
+constexpr uint32_t CIRL_IRP::logicalLead(const IRL_Timing_t &t) {
+    return uint32_t(t.markLead) + t.spaceLead;
+}
+
+
+constexpr uint32_t CIRL_IRP::logicalHolding(const IRL_Timing_t &t) {
+    return uint32_t(t.markHolding) + t.spaceHolding;
+}
+
+
+constexpr uint32_t CIRL_IRP::logicalZero(const IRL_Timing_t &t) {
+    return uint32_t(t.markZero) + t.spaceZero;
+}
+
+
+constexpr uint32_t CIRL_IRP::logicalOne(const IRL_Timing_t &t) {
+    return uint32_t(t.markOne) + t.spaceOne;
+}
+
+
+// Time between two holding frames. Without holding frames the frame
+// is repeated, assume half of the bits to be ones.
+constexpr uint32_t CIRL_IRP::timespanHolding(const IRL_Timing_t &t) {
+    return holding(t) ? t.spaceEndHolding + logicalHolding(t) :
+           t.spaceEnd + logicalLead(t) +
+           (t.bits / 2) * logicalOne(t) + (t.bits / 2) * logicalZero(t);
+}
+
+
+constexpr uint32_t CIRL_IRP::limitLogic(const IRL_Timing_t &t) {
+    return (logicalOne(t) + logicalZero(t)) / 2;
+}
+
+
+constexpr uint32_t CIRL_IRP::limitHolding(const IRL_Timing_t &t) {
+    return holding(t) ? (logicalHolding(t) + logicalOne(t)) / 2 :
+           (logicalLead(t) + logicalOne(t)) / 2;
+}
+
+
+// Without holding frames there is no lead to differentiate
+constexpr uint32_t CIRL_IRP::limitLead(const IRL_Timing_t &t) {
+    return holding(t) ? (logicalLead(t) + logicalHolding(t)) / 2 : 0;
+}
+
+
+constexpr uint32_t CIRL_IRP::limitTimeout(const IRL_Timing_t &t) {
+    return (t.spaceEnd + logicalLead(t)) / 2;
+}
+
+
+constexpr uint32_t CIRL_IRP::limitRepeat(const IRL_Timing_t &t) {
+    return timespanHolding(t) * 3 / 2;
+}
+
+
+uint8_t CIRL_IRP::encode(const IRL_Timing_t &timing, const uint8_t* data,
+                         uint16_t* durations)
+{
+    uint8_t length = 0;
+    durations[length++] = timing.markLead;
+    durations[length++] = timing.spaceLead;
+
+    for (uint8_t i = 0; i < timing.bits; i++)
+    {
+        if (data[i / 8] & (1 << (i % 8))) {
+            durations[length++] = timing.markOne;
+            durations[length++] = timing.spaceOne;
+        }
+        else {
+            durations[length++] = timing.markZero;
+            durations[length++] = timing.spaceZero;
+        }
+    }
+
+    durations[length++] = timing.markEnd;
+    return length;
+}
+
+
+uint8_t CIRL_IRP::encodeHolding(const IRL_Timing_t &timing,
+                                uint16_t* durations)
+{
+    durations[0] = timing.markHolding;
+    durations[1] = timing.spaceHolding;
+    durations[2] = timing.markEnd;
+    return 3;
+}
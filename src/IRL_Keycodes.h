@@ -25,6 +25,7 @@ THE SOFTWARE.
 #pragma once
 
 #include "IRLremote.h"
+#include "IRL_Keymap.h"
 
 //==============================================================================
 // Protek 9700 Series
@@ -96,4 +97,82 @@ namespace IRL_Protek_Remote{
         IRL_KEYCODE_REC             = 0x36,
         IRL_KEYCODE_LIVE            = 0x37,
     };
+
+    // Unified keys of the remote
+    static constexpr IRL_KeyCode_t IRL_KEYS[] = {
+        { IRL_KEYCODE_POWER,        IRL_KEY_POWER },
+        { IRL_KEYCODE_MUTE,         IRL_KEY_MUTE },
+
+        { IRL_KEYCODE_SCREEN,       IRL_KEY_SCREEN },
+        { IRL_KEYCODE_SATELLITE,    IRL_KEY_SATELLITE },
+        { IRL_KEYCODE_TV_RADIO,     IRL_KEY_TV_RADIO },
+        { IRL_KEYCODE_TV_MUSIC,     IRL_KEY_TV_MUSIC },
+
+        { IRL_KEYCODE_1,            IRL_KEY_1 },
+        { IRL_KEYCODE_2,            IRL_KEY_2 },
+        { IRL_KEYCODE_3,            IRL_KEY_3 },
+        { IRL_KEYCODE_4,            IRL_KEY_4 },
+        { IRL_KEYCODE_5,            IRL_KEY_5 },
+        { IRL_KEYCODE_6,            IRL_KEY_6 },
+        { IRL_KEYCODE_7,            IRL_KEY_7 },
+        { IRL_KEYCODE_8,            IRL_KEY_8 },
+        { IRL_KEYCODE_9,            IRL_KEY_9 },
+        { IRL_KEYCODE_BACK,         IRL_KEY_BACK },
+        { IRL_KEYCODE_0,            IRL_KEY_0 },
+        { IRL_KEYCODE_FAVORITE,     IRL_KEY_FAVORITE },
+
+        { IRL_KEYCODE_VOL_UP,       IRL_KEY_VOL_UP },
+        { IRL_KEYCODE_VOL_DOWN,     IRL_KEY_VOL_DOWN },
+        { IRL_KEYCODE_EPG,          IRL_KEY_EPG },
+        { IRL_KEYCODE_INFO,         IRL_KEY_INFO },
+        { IRL_KEYCODE_CHANNEL_UP,   IRL_KEY_CHANNEL_UP },
+        { IRL_KEYCODE_CHANNEL_DOWN, IRL_KEY_CHANNEL_DOWN },
+
+        { IRL_KEYCODE_UP,           IRL_KEY_UP },
+        { IRL_KEYCODE_DOWN,         IRL_KEY_DOWN },
+        { IRL_KEYCODE_LEFT,         IRL_KEY_LEFT },
+        { IRL_KEYCODE_RIGHT,        IRL_KEY_RIGHT },
+        { IRL_KEYCODE_OK,           IRL_KEY_OK },
+
+        { IRL_KEYCODE_EXIT,         IRL_KEY_EXIT },
+        { IRL_KEYCODE_MENU,         IRL_KEY_MENU },
+
+        { IRL_KEYCODE_I_II,         IRL_KEY_I_II },
+        { IRL_KEYCODE_TELETEXT,     IRL_KEY_TELETEXT },
+        { IRL_KEYCODE_SUBTITLE,     IRL_KEY_SUBTITLE },
+        { IRL_KEYCODE_ADD,          IRL_KEY_ADD },
+
+        { IRL_KEYCODE_RED,          IRL_KEY_RED },
+        { IRL_KEYCODE_GREEN,        IRL_KEY_GREEN },
+        { IRL_KEYCODE_YELLOW,       IRL_KEY_YELLOW },
+        { IRL_KEYCODE_BLUE,         IRL_KEY_BLUE },
+
+        { IRL_KEYCODE_PREV,         IRL_KEY_PREV },
+        { IRL_KEYCODE_PLAY,         IRL_KEY_PLAY },
+        { IRL_KEYCODE_STOP,         IRL_KEY_STOP },
+        { IRL_KEYCODE_NEXT,         IRL_KEY_NEXT },
+        { IRL_KEYCODE_USB,          IRL_KEY_USB },
+        { IRL_KEYCODE_PAUSE,        IRL_KEY_PAUSE },
+        { IRL_KEYCODE_REC,          IRL_KEY_REC },
+        { IRL_KEYCODE_LIVE,         IRL_KEY_LIVE },
+    };
+    typedef CIRL_KeymapTable<IRL_KEYS, sizeof(IRL_KEYS) / sizeof(IRL_KEYS[0])> IRL_KEYMAP_TABLE;
+    static constexpr IRL_Keymap_t IRL_KEYMAP = {
+        IRL_CAPTURE_PROTOCOL_NEC, IRL_ADDRESS, IRL_KEYMAP_TABLE::length, IRL_KEYMAP_TABLE::keys
+    };
 }
+
+//==============================================================================
+// All Remotes
+//==============================================================================
+
+// Add new remotes (for example generated with extra/host/Keymap_Gen.cpp)
+// sorted by protocol and address.
+static constexpr IRL_Keymap_t IRL_KEYMAPS[] PROGMEM = {
+    IRL_Protek_Remote::IRL_KEYMAP,
+};
+static_assert(CIRL_Keymap::sorted(IRL_KEYMAPS, sizeof(IRL_KEYMAPS) / sizeof(IRL_KEYMAPS[0])),
+              "Keymaps are not sorted by protocol and address");
+
+// Resolves the read() data of any known remote to a unified IRL_Key
+static constexpr CIRL_Keymap IRL_Keymap(IRL_KEYMAPS, sizeof(IRL_KEYMAPS) / sizeof(IRL_KEYMAPS[0]));
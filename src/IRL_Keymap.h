@@ -0,0 +1,296 @@
+/*
+Copyright (c) 2014-2018 NicoHood
+See the readme for credit to other people.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+// Include guard
+#pragma once
+
+#include "IRL_Platform.h"
+#include "IRL_Nec.h"
+#include "IRL_Sony.h"
+#include "IRL_RC5.h"
+#include "IRL_RC6.h"
+#include "IRL_Capture.h"
+#if defined(ARDUINO_ARCH_AVR) || defined(DMBS_ARCH_AVR8)
+#include <avr/pgmspace.h>
+#endif
+
+//==============================================================================
+// Keymap Definitions
+//==============================================================================
+
+// Unified keys of all remotes
+enum IRL_Key : uint8_t
+{
+    IRL_KEY_NONE = 0,
+
+    IRL_KEY_POWER,
+    IRL_KEY_MUTE,
+
+    IRL_KEY_SCREEN,
+    IRL_KEY_SATELLITE,
+    IRL_KEY_TV_RADIO,
+    IRL_KEY_TV_MUSIC,
+    IRL_KEY_TV,
+    IRL_KEY_SOURCE,
+
+    IRL_KEY_1,
+    IRL_KEY_2,
+    IRL_KEY_3,
+    IRL_KEY_4,
+    IRL_KEY_5,
+    IRL_KEY_6,
+    IRL_KEY_7,
+    IRL_KEY_8,
+    IRL_KEY_9,
+    IRL_KEY_0,
+    IRL_KEY_BACK,
+    IRL_KEY_FAVORITE,
+
+    IRL_KEY_VOL_UP,
+    IRL_KEY_VOL_DOWN,
+    IRL_KEY_EPG,
+    IRL_KEY_INFO,
+    IRL_KEY_CHANNEL_UP,
+    IRL_KEY_CHANNEL_DOWN,
+
+    IRL_KEY_UP,
+    IRL_KEY_DOWN,
+    IRL_KEY_LEFT,
+    IRL_KEY_RIGHT,
+    IRL_KEY_OK,
+
+    IRL_KEY_EXIT,
+    IRL_KEY_MENU,
+
+    IRL_KEY_I_II,
+    IRL_KEY_TELETEXT,
+    IRL_KEY_SUBTITLE,
+    IRL_KEY_ADD,
+
+    IRL_KEY_RED,
+    IRL_KEY_GREEN,
+    IRL_KEY_YELLOW,
+    IRL_KEY_BLUE,
+
+    IRL_KEY_PREV,
+    IRL_KEY_PLAY,
+    IRL_KEY_STOP,
+    IRL_KEY_NEXT,
+    IRL_KEY_USB,
+    IRL_KEY_PAUSE,
+    IRL_KEY_REC,
+    IRL_KEY_LIVE,
+    IRL_KEY_REWIND,
+    IRL_KEY_FORWARD,
+};
+
+// A command of a remote and its unified key
+struct IRL_KeyCode_t
+{
+    uint8_t command;
+    IRL_Key key;
+};
+
+// A remote in flash: the unified key of every command, indexed by command
+struct IRL_Keymap_t
+{
+    uint8_t protocol; // IRL_CAPTURE_PROTOCOL_*
+    uint16_t address;
+    uint16_t length;
+    const IRL_Key* keys;
+};
+
+//==============================================================================
+// IRL_Keymap Class
+//==============================================================================
+
+// Resolves (protocol, address, command) of any known remote to a unified key.
+// The remotes are sorted by protocol and address (check with static_assert
+// and CIRL_Keymap::sorted()) and searched binary, the command is a direct
+// index into the table of the remote. A lookup is O(log n) in the number of
+// remotes and O(1) in the number of commands.
+// The protocol numbers are the ones of the capture format (IRL_Capture.h).
+class CIRL_Keymap
+{
+public:
+    constexpr CIRL_Keymap(const IRL_Keymap_t* remotes, uint8_t length);
+
+    // Returns the key or IRL_KEY_NONE
+    inline IRL_Key lookup(uint8_t protocol, uint16_t address, uint8_t command) const;
+    inline IRL_Key lookup(const Nec_data_t& data) const;
+    inline IRL_Key lookup(const Sony_data_t& data) const;
+    inline IRL_Key lookup(const RC5_data_t& data) const;
+    inline IRL_Key lookup(const RC6_data_t& data) const;
+
+    // Check if the remotes are sorted (strictly increasing)
+    static constexpr bool sorted(const IRL_Keymap_t* remotes, uint8_t length);
+
+    // Sort key of a remote
+    static constexpr uint32_t id(uint8_t protocol, uint16_t address);
+
+    // Compile time helpers for the tables of the remotes
+    static constexpr uint8_t last(const IRL_KeyCode_t* codes, uint8_t count,
+                                  uint8_t max = 0);
+    static constexpr IRL_Key key(const IRL_KeyCode_t* codes, uint8_t count,
+                                 uint8_t command);
+    static constexpr bool unique(const IRL_KeyCode_t* codes, uint8_t count);
+
+protected:
+    const IRL_Keymap_t* mremotes;
+    uint8_t mlength;
+};
+
+//==============================================================================
+// IRL_KeymapTable Class
+//==============================================================================
+
+// Index list for the table generation (std::index_sequence is C++14)
+template<uint8_t... I>
+struct IRL_Indices {};
+
+template<uint16_t N, uint8_t... I>
+struct IRL_MakeIndices : IRL_MakeIndices<N - 1, N - 1, I...> {};
+
+template<uint8_t... I>
+struct IRL_MakeIndices<0, I...> { typedef IRL_Indices<I...> type; };
+
+// Generates the flash table of a remote at compile time from its list of
+// commands. The table has an entry for every command up to the highest one,
+// so a lookup is a single flash read.
+template<const IRL_KeyCode_t* codes, uint8_t count,
+         class Indices = typename IRL_MakeIndices<
+             CIRL_Keymap::last(codes, count) + 1>::type>
+class CIRL_KeymapTable;
+
+template<const IRL_KeyCode_t* codes, uint8_t count, uint8_t... I>
+class CIRL_KeymapTable<codes, count, IRL_Indices<I...>>
+{
+public:
+    static_assert(count, "Keymap has no commands");
+    static_assert(CIRL_Keymap::unique(codes, count), "Keymap lists a command twice");
+
+    static constexpr uint16_t length = sizeof...(I);
+    static constexpr IRL_Key keys[sizeof...(I)] PROGMEM = {
+        CIRL_Keymap::key(codes, count, I)...
+    };
+};
+
+template<const IRL_KeyCode_t* codes, uint8_t count, uint8_t... I>
+constexpr IRL_Key CIRL_KeymapTable<codes, count, IRL_Indices<I...>>::keys[sizeof...(I)] PROGMEM;
+
+
+//==============================================================================
+// CIRL_Keymap Implementation
+//==============================================================================
+
+constexpr CIRL_Keymap::CIRL_Keymap(const IRL_Keymap_t* remotes, uint8_t length)
+    : mremotes(remotes), mlength(length) {}
+
+
+constexpr uint32_t CIRL_Keymap::id(uint8_t protocol, uint16_t address) {
+    return ((uint32_t)protocol << 16) | address;
+}
+
+
+constexpr bool CIRL_Keymap::sorted(const IRL_Keymap_t* remotes, uint8_t length) {
+    return length < 2 ? true :
+           id(remotes[0].protocol, remotes[0].address) <
+           id(remotes[1].protocol, remotes[1].address) &&
+           sorted(remotes + 1, length - 1);
+}
+
+
+constexpr uint8_t CIRL_Keymap::last(const IRL_KeyCode_t* codes, uint8_t count,
+                                    uint8_t max) {
+    return !count ? max :
+           last(codes + 1, count - 1,
+                codes[0].command > max ? codes[0].command : max);
+}
+
+
+constexpr IRL_Key CIRL_Keymap::key(const IRL_KeyCode_t* codes, uint8_t count,
+                                   uint8_t command) {
+    return !count ? IRL_KEY_NONE :
+           codes[0].command == command ? codes[0].key :
+           key(codes + 1, count - 1, command);
+}
+
+
+constexpr bool CIRL_Keymap::unique(const IRL_KeyCode_t* codes, uint8_t count) {
+    return !count ? true :
+           key(codes + 1, count - 1, codes[0].command) == IRL_KEY_NONE &&
+           unique(codes + 1, count - 1);
+}
+
+
+IRL_Key CIRL_Keymap::lookup(uint8_t protocol, uint16_t address,
+                            uint8_t command) const
+{
+    uint32_t search = id(protocol, address);
+    uint8_t first = 0;
+    uint8_t last = mlength;
+    while (first < last)
+    {
+        uint8_t middle = first + (last - first) / 2;
+        const IRL_Keymap_t* remote = &mremotes[middle];
+        uint32_t value = id(pgm_read_byte(&remote->protocol),
+                            pgm_read_word(&remote->address));
+        if (value == search)
+        {
+            // Commands above the highest one of the remote are unknown
+            if (command >= pgm_read_word(&remote->length)) {
+                return IRL_KEY_NONE;
+            }
+            const IRL_Key* keys = (const IRL_Key*)pgm_read_ptr(&remote->keys);
+            return (IRL_Key)pgm_read_byte(&keys[command]);
+        }
+        if (value < search) {
+            first = middle + 1;
+        }
+        else {
+            last = middle;
+        }
+    }
+    return IRL_KEY_NONE;
+}
+
+
+IRL_Key CIRL_Keymap::lookup(const Nec_data_t& data) const {
+    return lookup(IRL_CAPTURE_PROTOCOL_NEC, data.address, data.command);
+}
+
+
+IRL_Key CIRL_Keymap::lookup(const Sony_data_t& data) const {
+    return lookup(IRL_CAPTURE_PROTOCOL_SONY, data.address, data.command);
+}
+
+
+IRL_Key CIRL_Keymap::lookup(const RC5_data_t& data) const {
+    return lookup(IRL_CAPTURE_PROTOCOL_RC5, data.address, data.command);
+}
+
+
+IRL_Key CIRL_Keymap::lookup(const RC6_data_t& data) const {
+    return lookup(IRL_CAPTURE_PROTOCOL_RC6, data.address, data.command);
+}
@@ -0,0 +1,192 @@
+/*
+Copyright (c) 2014-2018 NicoHood
+See the readme for credit to other people.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+// Include guard
+#pragma once
+
+#include "IRL_Platform.h"
+#include "IRL_Receive.h"
+#include "IRL_Time.h"
+
+//==============================================================================
+// Definitions
+//==============================================================================
+
+// The longest mark of all protocols is the NEC lead mark (9ms).
+// Any longer duration is a space, so the following edge is a falling edge.
+#define IRL_MULTI_LIMIT_MARK 12000UL
+
+//==============================================================================
+// IRL_Multi Class
+//==============================================================================
+
+template<class... Protocols>
+class CIRL_Multi : public CIRL_Receive<CIRL_Multi<Protocols...>>,
+                   protected CIRL_Time<CIRL_Multi<Protocols...>>
+{
+public:
+    // User API to access library data
+    inline bool available(void);
+    inline bool receiving(void);
+
+#ifdef IRL_DEFERRED_DECODE
+    using CIRL_Time<CIRL_Multi<Protocols...>>::poll;
+#endif
+
+protected:
+    typedef CIRL_Time<CIRL_Multi<Protocols...>> Time;
+    friend CIRL_Receive<CIRL_Multi<Protocols...>>;
+    friend Time;
+
+    // Interrupt function that is attached
+    static void interrupt(void);
+    static constexpr uint8_t interruptMode = CHANGE;
+
+    // Decode a single edge with all protocols
+    static inline void decode(uint16_t duration);
+    template<class P>
+    static inline void decodeProtocol(uint16_t duration, uint16_t pair,
+                                      bool falling);
+
+    // Level of the pin before the current edge and previous edge duration
+    static uint8_t mlevel;
+    static uint16_t mlastDuration;
+};
+
+
+//==============================================================================
+// Static Data
+//==============================================================================
+
+template<class... Protocols>
+uint8_t CIRL_Multi<Protocols...>::mlevel = HIGH;
+template<class... Protocols>
+uint16_t CIRL_Multi<Protocols...>::mlastDuration = 0;
+
+
+//==============================================================================
+// CIRL_Multi Implementation
+//==============================================================================
+
+/*
+ * Returns true if any protocol has new data.
+ * Call available()/read() of the single protocols afterwards.
+ */
+template<class... Protocols>
+bool CIRL_Multi<Protocols...>::available(void)
+{
+#ifdef IRL_DEFERRED_DECODE
+    poll();
+#else
+    // The last edge may be held back by the glitch filter
+    Time::release();
+#endif
+
+    // Check all protocols, some detect new data with a timeout check
+    bool ret = false;
+    bool check[] = { false, (ret |= Protocols().available())... };
+    (void)check;
+    return ret;
+}
+
+
+/*
+ * Return true if any protocol is currently receiving new data
+ */
+template<class... Protocols>
+bool CIRL_Multi<Protocols...>::receiving(void)
+{
+#ifdef IRL_DEFERRED_DECODE
+    poll();
+#else
+    Time::release();
+#endif
+
+    bool ret = false;
+    bool check[] = { false, (ret |= Protocols().receiving())... };
+    (void)check;
+    return ret;
+}
+
+
+template<class... Protocols>
+void CIRL_Multi<Protocols...>::interrupt(void)
+{
+#ifdef IRL_DEFERRED_DECODE
+    // Only save the time, decoding is done in the main loop
+    Time::capture();
+#else
+    // Get time between previous call once for all protocols
+    uint16_t duration = Time::nextTime();
+    if (!Time::glitch(duration)) {
+        decode(duration);
+    }
+#endif
+}
+
+
+template<class... Protocols>
+void CIRL_Multi<Protocols...>::decode(uint16_t duration)
+{
+    // After a long space the line was idle, resynchronize the edge type
+    if (duration >= Time::durationLimit(IRL_MULTI_LIMIT_MARK)) {
+        mlevel = HIGH;
+    }
+    bool falling = mlevel;
+    mlevel = !mlevel;
+
+    // Falling edge protocols decode the duration of a mark + space
+    uint16_t pair = 0xFFFF;
+    if (uint32_t(mlastDuration) + duration < 0xFFFF) {
+        pair = mlastDuration + duration;
+    }
+    mlastDuration = duration;
+
+    // Call every protocol in order. Protocols that already recognized or
+    // rejected the current frame return right at the beginning.
+    int call[] = { 0, (decodeProtocol<Protocols>(duration, pair, falling), 0)... };
+    (void)call;
+}
+
+
+template<class... Protocols>
+template<class P>
+void CIRL_Multi<Protocols...>::decodeProtocol(uint16_t duration, uint16_t pair,
+                                             bool falling)
+{
+    // Resolved at compile time, only the matching branch is generated
+    if (P::interruptMode == CHANGE)
+    {
+        P::mlastTime = Time::mlastTime;
+        P::msequence++;
+        P::decode(duration);
+    }
+    else if ((P::interruptMode == FALLING && falling) ||
+             (P::interruptMode == RISING && !falling))
+    {
+        P::mlastTime = Time::mlastTime;
+        P::msequence++;
+        P::decode(pair);
+    }
+}
@@ -28,45 +28,49 @@ THE SOFTWARE.
 #include "IRL_Time.h"
 #include "IRL_Protocol.h"
 #include "IRL_Decode.h"
+#include "IRL_IRP.h"
 
 //==============================================================================
 // Protocol Definitions
 //==============================================================================
 
 // NEC
-// IRP notation:
-// {38.4k,564}<1,-1|1,-3>(16,-8,D:8,S:8,F:8,~F:8,1,-78,(16,-4,1,-173)*)
+// IRP notation (the common notation has 38.4k, the library sends 38kHz):
+// {38k,564}<1,-1|1,-3>(16,-8,D:8,S:8,F:8,~F:8,1,-78,(16,-4,1,-173)*)
 // Lead + Space logic
-#define NEC_HZ                38000UL
-#define NEC_PULSE             564UL
+#define NEC_IRP               "{38k,564}<1,-1|1,-3>(16,-8,D:8,S:8,F:8,~F:8,1,-78,(16,-4,1,-173)*)"
+#define NEC_TIMING            CIRL_IRP::timing(NEC_IRP)
 #define NEC_ADDRESS_LENGTH    16
 #define NEC_COMMAND_LENGTH    16
-#define NEC_DATA_LENGTH       (NEC_ADDRESS_LENGTH + NEC_COMMAND_LENGTH)
-#define NEC_BLOCKS            (NEC_DATA_LENGTH / 8)
-// 2 for lead + space, each block has mark and space
-#define NEC_LENGTH            (2 + NEC_DATA_LENGTH * 2)
-#define NEC_TIMEOUT           (NEC_PULSE * 78UL)
-#define NEC_TIMEOUT_HOLDING   (NEC_PULSE * 173UL)
-#define NEC_TIMESPAN_HOLDING  (NEC_TIMEOUT_HOLDING + NEC_LOGICAL_HOLDING)
-#define NEC_MARK_LEAD         (NEC_PULSE * 16UL)
-#define NEC_MARK_HOLDING      (NEC_PULSE * 16UL)
-#define NEC_SPACE_LEAD        (NEC_PULSE * 8UL)
-#define NEC_SPACE_HOLDING     (NEC_PULSE * 4UL)
-#define NEC_LOGICAL_LEAD      (NEC_MARK_LEAD + NEC_SPACE_LEAD)
-#define NEC_LOGICAL_HOLDING   (NEC_MARK_LEAD + NEC_SPACE_HOLDING)
-#define NEC_MARK_ZERO         (NEC_PULSE * 1UL)
-#define NEC_MARK_ONE          (NEC_PULSE * 1UL)
-#define NEC_SPACE_ZERO        (NEC_PULSE * 1UL)
-#define NEC_SPACE_ONE         (NEC_PULSE * 3UL)
-#define NEC_LOGICAL_ZERO      (NEC_MARK_ZERO + NEC_SPACE_ZERO)
-#define NEC_LOGICAL_ONE       (NEC_MARK_ONE + NEC_SPACE_ONE)
+#define NEC_BLOCKS            CIRL_IRP::blocks(NEC_TIMING)
+
+// Timings and limits, generated from the IRP notation
+#define NEC_HZ                NEC_TIMING.hz
+#define NEC_PULSE             NEC_TIMING.unit
+#define NEC_DATA_LENGTH       NEC_TIMING.bits
+#define NEC_LENGTH            CIRL_IRP::length(NEC_TIMING)
+#define NEC_TIMEOUT           NEC_TIMING.spaceEnd
+#define NEC_TIMEOUT_HOLDING   NEC_TIMING.spaceEndHolding
+#define NEC_TIMESPAN_HOLDING  CIRL_IRP::timespanHolding(NEC_TIMING)
+#define NEC_MARK_LEAD         NEC_TIMING.markLead
+#define NEC_MARK_HOLDING      NEC_TIMING.markHolding
+#define NEC_SPACE_LEAD        NEC_TIMING.spaceLead
+#define NEC_SPACE_HOLDING     NEC_TIMING.spaceHolding
+#define NEC_LOGICAL_LEAD      CIRL_IRP::logicalLead(NEC_TIMING)
+#define NEC_LOGICAL_HOLDING   CIRL_IRP::logicalHolding(NEC_TIMING)
+#define NEC_MARK_ZERO         NEC_TIMING.markZero
+#define NEC_MARK_ONE          NEC_TIMING.markOne
+#define NEC_SPACE_ZERO        NEC_TIMING.spaceZero
+#define NEC_SPACE_ONE         NEC_TIMING.spaceOne
+#define NEC_LOGICAL_ZERO      CIRL_IRP::logicalZero(NEC_TIMING)
+#define NEC_LOGICAL_ONE       CIRL_IRP::logicalOne(NEC_TIMING)
 
 // Decoding limits
-#define NEC_LIMIT_LOGIC       ((NEC_LOGICAL_ONE + NEC_LOGICAL_ZERO) / 2)
-#define NEC_LIMIT_HOLDING     ((NEC_LOGICAL_HOLDING + NEC_LOGICAL_ONE) / 2)
-#define NEC_LIMIT_LEAD        ((NEC_LOGICAL_LEAD + NEC_LOGICAL_HOLDING) / 2)
-#define NEC_LIMIT_TIMEOUT     ((NEC_TIMEOUT + NEC_LOGICAL_LEAD) / 2)
-#define NEC_LIMIT_REPEAT      (NEC_TIMESPAN_HOLDING * 3 / 2)
+#define NEC_LIMIT_LOGIC       CIRL_IRP::limitLogic(NEC_TIMING)
+#define NEC_LIMIT_HOLDING     CIRL_IRP::limitHolding(NEC_TIMING)
+#define NEC_LIMIT_LEAD        CIRL_IRP::limitLead(NEC_TIMING)
+#define NEC_LIMIT_TIMEOUT     CIRL_IRP::limitTimeout(NEC_TIMING)
+#define NEC_LIMIT_REPEAT      CIRL_IRP::limitRepeat(NEC_TIMING)
 
 /*
  * Nec pulse demonstration:
@@ -109,36 +113,42 @@ struct Nec_data_t
 // Nec Decoding Class
 //==============================================================================
 
-class CNec : public CIRL_Receive<CNec>,
-             public CIRL_Time<CNec>,
-             public CIRL_Protocol<CNec, Nec_data_t>,
-             public CIRL_DecodeSpaces<CNec, NEC_BLOCKS>
+// Each instance number has its own decoding state and interrupt function.
+// Use different numbers (for example the pin number) for multiple receivers.
+template<uint8_t instance>
+class CNecInstance : public CIRL_Receive<CNecInstance<instance>>,
+                     public CIRL_Time<CNecInstance<instance>>,
+                     public CIRL_Protocol<CNecInstance<instance>, Nec_data_t>,
+                     public CIRL_DecodeSpaces<CNecInstance<instance>, NEC_BLOCKS>
 {
 protected:
-    static constexpr uint32_t timespanEvent = NEC_TIMESPAN_HOLDING;
-    static constexpr uint32_t limitTimeout = NEC_LIMIT_TIMEOUT;
-    static constexpr uint32_t limitLead = NEC_LIMIT_LEAD;
-    static constexpr uint32_t limitHolding = NEC_LIMIT_HOLDING;
-    static constexpr uint32_t limitLogic = NEC_LIMIT_LOGIC;
-    static constexpr uint32_t limitRepeat = NEC_LIMIT_REPEAT;
-    static constexpr uint8_t irLength = NEC_LENGTH;
-
-    friend CIRL_Receive<CNec>;
-    friend CIRL_Protocol<CNec, Nec_data_t>;
-    friend CIRL_DecodeSpaces<CNec, NEC_BLOCKS>;
+    IRL_IRP_SPACES(NEC_IRP);
+
+    friend CIRL_Receive<CNecInstance>;
+    friend CIRL_Time<CNecInstance>;
+    template<class...> friend class CIRL_Multi;
+    friend CIRL_Protocol<CNecInstance, Nec_data_t>;
+    friend CIRL_DecodeSpaces<CNecInstance, NEC_BLOCKS>;
 
     // Protocol interface functions
-    inline Nec_data_t getData(void);
+    static inline Nec_data_t getData(void);
     static inline bool checksum(void);
     static inline void holding(void);
+
+    // Decoding buffer of this instance
+    using CIRL_DecodeSpaces<CNecInstance, NEC_BLOCKS>::data;
 };
 
+// Default receiver
+typedef CNecInstance<0> CNec;
+
 
 //==============================================================================
 // Nec Decoding Implementation
 //==============================================================================
 
-Nec_data_t CNec::getData(void){
+template<uint8_t instance>
+Nec_data_t CNecInstance<instance>::getData(void){
     Nec_data_t retdata;
     retdata.address = ((uint16_t)data[1] << 8) | ((uint16_t)data[0]);
     retdata.command = data[2];
@@ -146,12 +156,14 @@ Nec_data_t CNec::getData(void){
 }
 
 
-bool CNec::checksum(void) {
+template<uint8_t instance>
+bool CNecInstance<instance>::checksum(void) {
     return uint8_t((data[2] ^ (~data[3]))) == 0x00;
 }
 
 
-void CNec::holding(void) {
+template<uint8_t instance>
+void CNecInstance<instance>::holding(void) {
     // Flag repeat signal via "invalid" address and empty command
     data[0] = 0xFF;
     data[1] = 0xFF;
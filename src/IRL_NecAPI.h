@@ -33,8 +33,9 @@ THE SOFTWARE.
 typedef void(*NecEventCallback)(void);
 #define NEC_API_PRESS_TIMEOUT (500UL * 1000UL) // 0.5 seconds
 
-template<const NecEventCallback callback, const uint16_t address = 0x0000>
-class CNecAPI : public CNec
+template<const NecEventCallback callback, const uint16_t address = 0x0000,
+         const uint8_t instance = 0>
+class CNecAPI : public CNecInstance<instance>
 {
 public:
     // User API to access library data
@@ -60,6 +61,10 @@ protected:
     uint8_t lastCommand = 0;
     uint8_t lastPressCount = 0;
     uint8_t lastHoldCount = 0;
+
+    // Receiver and time functions of this instance
+    typedef CNecInstance<instance> Receiver;
+    using Receiver::timeout;
 };
 
 //==============================================================================
@@ -67,9 +72,10 @@ protected:
 //==============================================================================
 
 // Reads data from the nec protocol (if available) and processes it.
-template<const NecEventCallback callback, const uint16_t address>
-void CNecAPI<callback, address>::read(void) {
-  auto data = CNec::read();
+template<const NecEventCallback callback, const uint16_t address,
+         const uint8_t instance>
+void CNecAPI<callback, address, instance>::read(void) {
+  auto data = Receiver::read();
 
   // Check if the correct protocol and address (optional) is used
   bool firstCommand = data.address != 0xFFFF;
@@ -143,23 +149,26 @@ void CNecAPI<callback, address>::read(void) {
 }
 
 
-template<const NecEventCallback callback, const uint16_t address>
-uint8_t CNecAPI<callback, address>::command(void)
+template<const NecEventCallback callback, const uint16_t address,
+         const uint8_t instance>
+uint8_t CNecAPI<callback, address, instance>::command(void)
 {
     return lastCommand;
 }
 
 // Number of repeating button presses in a row
-template<const NecEventCallback callback, const uint16_t address>
-uint8_t CNecAPI<callback, address>::count(void)
+template<const NecEventCallback callback, const uint16_t address,
+         const uint8_t instance>
+uint8_t CNecAPI<callback, address, instance>::count(void)
 {
     return lastPressCount;
 }
 
 // Duration (count) how long the current button press was held down.
 // Pass true to also recognize keyup events
-template<const NecEventCallback callback, const uint16_t address>
-uint8_t CNecAPI<callback, address>::duration(bool raw)
+template<const NecEventCallback callback, const uint16_t address,
+         const uint8_t instance>
+uint8_t CNecAPI<callback, address, instance>::duration(bool raw)
 {
     // Only recognize the actual keydown event
     if (NecTimeoutType == NO_TIMEOUT || raw) // TODO reorder?
@@ -180,8 +189,9 @@ uint8_t CNecAPI<callback, address>::duration(bool raw)
 // 2. Holding button down
 // 3. Renewed button press
 // Usually you want to use timeout() to check if the series ends
-template<const NecEventCallback callback, const uint16_t address>
-uint8_t CNecAPI<callback, address>::released(bool samebutton)
+template<const NecEventCallback callback, const uint16_t address,
+         const uint8_t instance>
+uint8_t CNecAPI<callback, address, instance>::released(bool samebutton)
 {
     if (NecTimeoutType == TIMEOUT || NecTimeoutType == NEW_BUTTON) {
         return 1 + lastHoldCount;
@@ -192,15 +202,17 @@ uint8_t CNecAPI<callback, address>::released(bool samebutton)
     return 0;
 }
 
-template<const NecEventCallback callback, const uint16_t address>
-constexpr uint32_t CNecAPI<callback, address>::getTimeout(void) {
+template<const NecEventCallback callback, const uint16_t address,
+         const uint8_t instance>
+constexpr uint32_t CNecAPI<callback, address, instance>::getTimeout(void) {
     return NEC_API_PRESS_TIMEOUT;
 }
 
 // Return when the next timeout triggers.
 // Zero means it already timed out.
-template<const NecEventCallback callback, const uint16_t address>
-uint32_t CNecAPI<callback, address>::nextTimeout(void)
+template<const NecEventCallback callback, const uint16_t address,
+         const uint8_t instance>
+uint32_t CNecAPI<callback, address, instance>::nextTimeout(void)
 {
     auto time = timeout();
     auto timeout = getTimeout();
@@ -211,3 +223,269 @@ uint32_t CNecAPI<callback, address>::nextTimeout(void)
 
     return timeout - time;
 }
+
+//==============================================================================
+// Multi Remote API Class
+//==============================================================================
+
+// Like CNecAPI, but keeps the press/hold state of up to `remotes` addresses,
+// so several remotes can be used at the same time. If the table is full the
+// least recently used remote is released and replaced.
+// NEC holding frames have no address, they belong to the remote of the last
+// full frame.
+template<const NecEventCallback callback, const uint8_t remotes = 4,
+         const uint8_t instance = 0>
+class CNecMultiAPI : public CNecInstance<instance>
+{
+public:
+    // User API to access library data
+    inline void read(void);
+    inline uint16_t address(void);
+    inline uint8_t command(void);
+    inline uint8_t count(void);
+    inline uint8_t duration(bool raw = false);
+    inline uint8_t released(bool samebutton = false);
+    inline constexpr uint32_t getTimeout(void);
+    inline uint32_t nextTimeout(void);
+
+protected:
+    static_assert(remotes >= 1 && remotes < 0xFF, "Invalid number of remotes");
+
+    // Differenciate between timeout types
+    enum TimeoutType : uint8_t
+    {
+        NO_TIMEOUT,     // Keydown
+        TIMEOUT,        // Key release with timeout
+        NEXT_BUTTON,    // Key release, pressed again
+        NEW_BUTTON,     // Key release, another key is pressed
+    } NecTimeoutType;
+
+    // Keep track which key of every remote was pressed/held down how often
+    struct Remote
+    {
+        uint16_t address;
+        uint8_t command;
+        uint8_t pressCount;
+        uint8_t holdCount;
+        uint32_t lastTime;
+    };
+    Remote mremotes[remotes] = {};
+
+    // Remote of the current callback and of the last full frame
+    uint8_t mcurrent = 0;
+    uint8_t mlastRemote = 0xFF;
+
+    inline uint8_t find(uint16_t address, uint32_t time);
+    inline void release(uint8_t remote, TimeoutType type);
+
+    // Receiver and time functions of this instance
+    typedef CNecInstance<instance> Receiver;
+};
+
+//==============================================================================
+// Multi Remote API Class Implementation
+//==============================================================================
+
+// Reads data from the nec protocol (if available) and processes it.
+template<const NecEventCallback callback, const uint8_t remotes,
+         const uint8_t instance>
+void CNecMultiAPI<callback, remotes, instance>::read(void)
+{
+    auto data = Receiver::read();
+
+    // Timeouts are checked against the time of the new frame, if any
+    bool newData = data.address != 0;
+    uint32_t time = newData ? Receiver::readTime() : Receiver::Timebase::now();
+    for (uint8_t i = 0; i < remotes; i++)
+    {
+        // Reset the button press and hold count after a timeout
+        if (mremotes[i].pressCount &&
+            (time - mremotes[i].lastTime) > Receiver::Timebase::ticks(getTimeout())) {
+            release(i, TIMEOUT);
+        }
+    }
+    if (!newData) {
+        return;
+    }
+
+    // Count the button holding of the last remote
+    if (data.address == 0xFFFF)
+    {
+        // Abort if no first press was recognized (after reset or timeout)
+        if (mlastRemote >= remotes || !mremotes[mlastRemote].pressCount) {
+            return;
+        }
+
+        Remote &remote = mremotes[mlastRemote];
+        if (remote.holdCount < 255) {
+            remote.holdCount++;
+        }
+        remote.lastTime = time;
+        mcurrent = mlastRemote;
+        NecTimeoutType = NO_TIMEOUT;
+        callback();
+        return;
+    }
+
+    // Count the first button press of this remote
+    uint8_t index = find(data.address, time);
+    Remote &remote = mremotes[index];
+    if (remote.pressCount && data.command == remote.command)
+    {
+        // The same button was pressed twice in a short timespawn (500ms)
+        release(index, NEXT_BUTTON);
+        remote.pressCount++;
+        if (remote.pressCount == 0) {
+            remote.pressCount = 255;
+        }
+    }
+    else
+    {
+        // Flag that the last button hold is over, a differnt key is now held down
+        if (remote.pressCount) {
+            release(index, NEW_BUTTON);
+        }
+        remote.pressCount = 1;
+    }
+
+    // Start a new series of button holding
+    remote.holdCount = 0;
+    remote.command = data.command;
+    remote.lastTime = time;
+    mlastRemote = index;
+
+    // Call the remote function and flag that the event was just received
+    mcurrent = index;
+    NecTimeoutType = NO_TIMEOUT;
+    callback();
+}
+
+
+// Returns the table entry of the address. A new address gets a free entry
+// or replaces the least recently used remote.
+template<const NecEventCallback callback, const uint8_t remotes,
+         const uint8_t instance>
+uint8_t CNecMultiAPI<callback, remotes, instance>::find(uint16_t address,
+                                                        uint32_t time)
+{
+    uint8_t oldest = 0;
+    uint32_t oldestAge = 0;
+    bool oldestFree = false;
+    for (uint8_t i = 0; i < remotes; i++)
+    {
+        if (mremotes[i].pressCount && mremotes[i].address == address) {
+            return i;
+        }
+
+        // Prefer released entries, then the oldest one
+        bool free = !mremotes[i].pressCount;
+        uint32_t age = time - mremotes[i].lastTime;
+        if ((free && !oldestFree) || (free == oldestFree && age >= oldestAge))
+        {
+            oldest = i;
+            oldestAge = age;
+            oldestFree = free;
+        }
+    }
+
+    // Release the replaced remote
+    if (mremotes[oldest].pressCount) {
+        release(oldest, TIMEOUT);
+    }
+    if (mlastRemote == oldest) {
+        mlastRemote = 0xFF;
+    }
+    mremotes[oldest].address = address;
+    return oldest;
+}
+
+
+// Calls the remote function with a release event. The press and hold count
+// are reset after a timeout only, the others continue or start a series.
+template<const NecEventCallback callback, const uint8_t remotes,
+         const uint8_t instance>
+void CNecMultiAPI<callback, remotes, instance>::release(uint8_t remote,
+                                                        TimeoutType type)
+{
+    mcurrent = remote;
+    NecTimeoutType = type;
+    callback();
+
+    if (type == TIMEOUT) {
+        mremotes[remote].pressCount = 0;
+        mremotes[remote].holdCount = 0;
+    }
+}
+
+
+template<const NecEventCallback callback, const uint8_t remotes,
+         const uint8_t instance>
+uint16_t CNecMultiAPI<callback, remotes, instance>::address(void)
+{
+    return mremotes[mcurrent].address;
+}
+
+
+template<const NecEventCallback callback, const uint8_t remotes,
+         const uint8_t instance>
+uint8_t CNecMultiAPI<callback, remotes, instance>::command(void)
+{
+    return mremotes[mcurrent].command;
+}
+
+// Number of repeating button presses in a row
+template<const NecEventCallback callback, const uint8_t remotes,
+         const uint8_t instance>
+uint8_t CNecMultiAPI<callback, remotes, instance>::count(void)
+{
+    return mremotes[mcurrent].pressCount;
+}
+
+// Duration (count) how long the current button press was held down.
+// Pass true to also recognize keyup events
+template<const NecEventCallback callback, const uint8_t remotes,
+         const uint8_t instance>
+uint8_t CNecMultiAPI<callback, remotes, instance>::duration(bool raw)
+{
+    if (NecTimeoutType == NO_TIMEOUT || raw) {
+        return 1 + mremotes[mcurrent].holdCount;
+    }
+    return 0;
+}
+
+// True when the button is released, see CNecAPI::released()
+template<const NecEventCallback callback, const uint8_t remotes,
+         const uint8_t instance>
+uint8_t CNecMultiAPI<callback, remotes, instance>::released(bool samebutton)
+{
+    if (NecTimeoutType == TIMEOUT || NecTimeoutType == NEW_BUTTON) {
+        return 1 + mremotes[mcurrent].holdCount;
+    }
+    if (samebutton && NecTimeoutType == NEXT_BUTTON) {
+        return 1 + mremotes[mcurrent].holdCount;
+    }
+    return 0;
+}
+
+template<const NecEventCallback callback, const uint8_t remotes,
+         const uint8_t instance>
+constexpr uint32_t CNecMultiAPI<callback, remotes, instance>::getTimeout(void) {
+    return NEC_API_PRESS_TIMEOUT;
+}
+
+// Return when the next timeout of the current remote triggers.
+// Zero means it already timed out.
+template<const NecEventCallback callback, const uint8_t remotes,
+         const uint8_t instance>
+uint32_t CNecMultiAPI<callback, remotes, instance>::nextTimeout(void)
+{
+    auto time = Receiver::Timebase::micros(Receiver::Timebase::now() -
+                                           mremotes[mcurrent].lastTime);
+    auto timeout = getTimeout();
+
+    if(time >= timeout) {
+        return 0;
+    }
+
+    return timeout - time;
+}
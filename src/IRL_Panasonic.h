@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "IRL_Time.h"
 #include "IRL_Protocol.h"
 #include "IRL_Decode.h"
+#include "IRL_IRP.h"
 
 //==============================================================================
 // Protocol Definitions
@@ -37,39 +38,36 @@ THE SOFTWARE.
 // IRP notation:
 // {37k,432}<1,-1|1,-3>(8,-4,3:8,1:8,D:8,S:8,F:8,(D^S^F):8,1,-173)+
 // Lead + Space logic
-#define PANASONIC_HZ                37000
-#define PANASONIC_PULSE             432UL
+#define PANASONIC_IRP               "{37k,432}<1,-1|1,-3>(8,-4,3:8,1:8,D:8,S:8,F:8,(D^S^F):8,1,-173)+"
+#define PANASONIC_TIMING            CIRL_IRP::timing(PANASONIC_IRP)
 #define PANASONIC_ADDRESS_LENGTH    16
 #define PANASONIC_COMMAND_LENGTH    32
-#define PANASONIC_DATA_LENGTH       (PANASONIC_ADDRESS_LENGTH + \
-                                    PANASONIC_COMMAND_LENGTH)
-#define PANASONIC_BLOCKS            (PANASONIC_DATA_LENGTH / 8)
-// 2 for lead + space, each block has mark and space
-#define PANASONIC_LENGTH            (2 + PANASONIC_DATA_LENGTH * 2)
-#define PANASONIC_TIMEOUT           (PANASONIC_PULSE * 173UL)
-#define PANASONIC_TIMESPAN_HOLDING  (PANASONIC_TIMEOUT + \
-                                    PANASONIC_LOGICAL_LEAD + \
-                                    (PANASONIC_DATA_LENGTH / 2) * \
-                                    PANASONIC_LOGICAL_ONE + \
-                                    (PANASONIC_DATA_LENGTH / 2) * \
-                                    PANASONIC_LOGICAL_ZERO)
-#define PANASONIC_MARK_LEAD         (PANASONIC_PULSE * 8UL)
-#define PANASONIC_SPACE_LEAD        (PANASONIC_PULSE * 4UL)
-#define PANASONIC_LOGICAL_LEAD      (PANASONIC_MARK_LEAD + PANASONIC_SPACE_LEAD)
+#define PANASONIC_BLOCKS            CIRL_IRP::blocks(PANASONIC_TIMING)
+
+// Timings and limits, generated from the IRP notation
+#define PANASONIC_HZ                PANASONIC_TIMING.hz
+#define PANASONIC_PULSE             PANASONIC_TIMING.unit
+#define PANASONIC_DATA_LENGTH       PANASONIC_TIMING.bits
+#define PANASONIC_LENGTH            CIRL_IRP::length(PANASONIC_TIMING)
+#define PANASONIC_TIMEOUT           PANASONIC_TIMING.spaceEnd
+#define PANASONIC_TIMESPAN_HOLDING  CIRL_IRP::timespanHolding(PANASONIC_TIMING)
+#define PANASONIC_MARK_LEAD         PANASONIC_TIMING.markLead
+#define PANASONIC_SPACE_LEAD        PANASONIC_TIMING.spaceLead
+#define PANASONIC_LOGICAL_LEAD      CIRL_IRP::logicalLead(PANASONIC_TIMING)
 // No holding function in this protocol
-#define PANASONIC_MARK_ZERO         (PANASONIC_PULSE * 1UL)
-#define PANASONIC_MARK_ONE          (PANASONIC_PULSE * 1UL)
-#define PANASONIC_SPACE_ZERO        (PANASONIC_PULSE * 1UL)
-#define PANASONIC_SPACE_ONE         (PANASONIC_PULSE * 3UL)
-#define PANASONIC_LOGICAL_ZERO      (PANASONIC_MARK_ZERO + PANASONIC_SPACE_ZERO)
-#define PANASONIC_LOGICAL_ONE       (PANASONIC_MARK_ONE + PANASONIC_SPACE_ONE)
+#define PANASONIC_MARK_ZERO         PANASONIC_TIMING.markZero
+#define PANASONIC_MARK_ONE          PANASONIC_TIMING.markOne
+#define PANASONIC_SPACE_ZERO        PANASONIC_TIMING.spaceZero
+#define PANASONIC_SPACE_ONE         PANASONIC_TIMING.spaceOne
+#define PANASONIC_LOGICAL_ZERO      CIRL_IRP::logicalZero(PANASONIC_TIMING)
+#define PANASONIC_LOGICAL_ONE       CIRL_IRP::logicalOne(PANASONIC_TIMING)
 
 // Decoding limits
-#define PANASONIC_LIMIT_LOGIC       ((PANASONIC_LOGICAL_ONE + PANASONIC_LOGICAL_ZERO) / 2)
-#define PANASONIC_LIMIT_HOLDING     ((PANASONIC_LOGICAL_LEAD + PANASONIC_LOGICAL_ONE) / 2)
-#define PANASONIC_LIMIT_LEAD        0
-#define PANASONIC_LIMIT_TIMEOUT     ((PANASONIC_TIMEOUT + PANASONIC_LOGICAL_LEAD) / 2)
-#define PANASONIC_LIMIT_REPEAT      (PANASONIC_TIMESPAN_HOLDING * 3 / 2)
+#define PANASONIC_LIMIT_LOGIC       CIRL_IRP::limitLogic(PANASONIC_TIMING)
+#define PANASONIC_LIMIT_HOLDING     CIRL_IRP::limitHolding(PANASONIC_TIMING)
+#define PANASONIC_LIMIT_LEAD        CIRL_IRP::limitLead(PANASONIC_TIMING)
+#define PANASONIC_LIMIT_TIMEOUT     CIRL_IRP::limitTimeout(PANASONIC_TIMING)
+#define PANASONIC_LIMIT_REPEAT      CIRL_IRP::limitRepeat(PANASONIC_TIMING)
 
 /*
 Panasonic pulse demonstration:
@@ -124,36 +122,42 @@ union Panasonic_data_t
 // Panasonic Decoding Class
 //==============================================================================
 
-class CPanasonic : public CIRL_Receive<CPanasonic>,
-             public CIRL_Time<CPanasonic>,
-             public CIRL_Protocol<CPanasonic, Panasonic_data_t>,
-             public CIRL_DecodeSpaces<CPanasonic, PANASONIC_BLOCKS>
+// Each instance number has its own decoding state and interrupt function.
+// Use different numbers (for example the pin number) for multiple receivers.
+template<uint8_t instance>
+class CPanasonicInstance : public CIRL_Receive<CPanasonicInstance<instance>>,
+             public CIRL_Time<CPanasonicInstance<instance>>,
+             public CIRL_Protocol<CPanasonicInstance<instance>, Panasonic_data_t>,
+             public CIRL_DecodeSpaces<CPanasonicInstance<instance>, PANASONIC_BLOCKS>
 {
 protected:
-    static constexpr uint32_t timespanEvent = PANASONIC_TIMESPAN_HOLDING;
-    static constexpr uint32_t limitTimeout = PANASONIC_LIMIT_TIMEOUT;
-    static constexpr uint32_t limitLead = PANASONIC_LIMIT_LEAD;
-    static constexpr uint32_t limitHolding = PANASONIC_LIMIT_HOLDING;
-    static constexpr uint32_t limitLogic = PANASONIC_LIMIT_LOGIC;
-    static constexpr uint32_t limitRepeat = PANASONIC_LIMIT_REPEAT;
-    static constexpr uint8_t irLength = PANASONIC_LENGTH;
-
-    friend CIRL_Receive<CPanasonic>;
-    friend CIRL_Protocol<CPanasonic, Panasonic_data_t>;
-    friend CIRL_DecodeSpaces<CPanasonic, PANASONIC_BLOCKS>;
+    IRL_IRP_SPACES(PANASONIC_IRP);
+
+    friend CIRL_Receive<CPanasonicInstance>;
+    friend CIRL_Time<CPanasonicInstance>;
+    template<class...> friend class CIRL_Multi;
+    friend CIRL_Protocol<CPanasonicInstance, Panasonic_data_t>;
+    friend CIRL_DecodeSpaces<CPanasonicInstance, PANASONIC_BLOCKS>;
 
     // Protocol interface functions
-    inline Panasonic_data_t getData(void);
+    static inline Panasonic_data_t getData(void);
     static inline bool checksum(void);
     static inline void holding(void);
+
+    // Decoding buffer of this instance
+    using CIRL_DecodeSpaces<CPanasonicInstance, PANASONIC_BLOCKS>::data;
 };
 
+// Default receiver
+typedef CPanasonicInstance<0> CPanasonic;
+
 
 //==============================================================================
 // Panasonic Decoding Implementation
 //==============================================================================
 
-Panasonic_data_t CPanasonic::getData(void) {
+template<uint8_t instance>
+Panasonic_data_t CPanasonicInstance<instance>::getData(void) {
     Panasonic_data_t retdata;
     retdata.address = ((uint16_t)data[1] << 8) |
                       ((uint16_t)data[0]);
@@ -165,7 +169,8 @@ Panasonic_data_t CPanasonic::getData(void) {
 }
 
 
-bool CPanasonic::checksum(void) {
+template<uint8_t instance>
+bool CPanasonicInstance<instance>::checksum(void) {
     // Check if the protcol's checksum is correct
     uint8_t XOR1 = data[2] ^
                    data[3] ^
@@ -183,7 +188,8 @@ bool CPanasonic::checksum(void) {
 }
 
 
-void CPanasonic::holding(void) {
+template<uint8_t instance>
+void CPanasonicInstance<instance>::holding(void) {
     // Holding not available for Panasonic protocol
     return;
 }
@@ -28,6 +28,15 @@ THE SOFTWARE.
 #include <Arduino.h> // micros()
 #endif
 
+// Build for the host (Linux, macOS) if no embedded platform was selected.
+// Useful for profiling and regression testing the decoders on a PC.
+#if !defined(ARDUINO) && !defined(DMBS_ARCH_AVR8) && !defined(ESP8266) && \
+    (defined(__unix__) || defined(__APPLE__))
+    #ifndef IRL_HOST
+    #define IRL_HOST
+    #endif
+#endif
+
 #if defined(ARDUINO_ARCH_AVR) || defined(DMBS_ARCH_AVR8)
     #include <util/atomic.h>
 #elif defined(ARDUINO_ARCH_ESP8266) || defined(ESP8266)
@@ -58,6 +67,15 @@ THE SOFTWARE.
     #define ATOMIC_BLOCK(A) \
         for ( SA_ATOMIC_RESTORESTATE, _sa_done =  1;    \
             _sa_done; _sa_done = 0 )
+#elif defined(IRL_HOST)
+    #include "IRL_Host.h"
 #else
-    #error "This library supports only AVR and ESP8266 Boards."
+    #error "This library supports only AVR and ESP8266 Boards and host builds."
 #endif
+
+// Prevent the compiler from reordering memory accesses, used to publish data
+// between the interrupt and the main loop without disabling interrupts
+#define IRL_MEMORY_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+// Timebase of the library (micros(), hardware input capture or cycles)
+#include "IRL_Timebase.h"
@@ -0,0 +1,278 @@
+/*
+Copyright (c) 2014-2018 NicoHood
+See the readme for credit to other people.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+// Include guard
+#pragma once
+
+#include "IRL_Platform.h"
+
+// ISR profiler: measures the cycles of every decoding branch.
+// Define before including IRLremote, compiled out otherwise.
+//#define IRL_PROFILER
+
+// Number of histogram buckets, the last bucket counts all longer durations
+#ifndef IRL_PROFILER_BUCKETS
+#define IRL_PROFILER_BUCKETS 16
+#endif
+
+// Width of a bucket in cycles (1 << IRL_PROFILER_SHIFT)
+#ifndef IRL_PROFILER_SHIFT
+#define IRL_PROFILER_SHIFT 4
+#endif
+
+#ifdef IRL_PROFILER
+
+// Cycle counter, only the lower 16 bit are used.
+// On AVR Timer1 runs with the CPU clock, started with CIRL_Profiler::begin().
+#ifndef IRL_PROFILER_CYCLES
+#if defined(IRL_HOST) && (defined(__x86_64__) || defined(__i386__))
+    #include <x86intrin.h>
+    #define IRL_PROFILER_CYCLES() ((uint16_t)__rdtsc())
+#elif defined(IRL_HOST)
+    #include <time.h>
+    static inline uint16_t IRL_ProfilerCycles(void) {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_nsec;
+    }
+    #define IRL_PROFILER_CYCLES() IRL_ProfilerCycles()
+#elif defined(ARDUINO_ARCH_AVR) || defined(DMBS_ARCH_AVR8)
+    #define IRL_PROFILER_CYCLES() ((uint16_t)TCNT1)
+#elif defined(ARDUINO_ARCH_ESP8266) || defined(ESP8266)
+    #define IRL_PROFILER_CYCLES() ((uint16_t)ESP.getCycleCount())
+#endif
+#endif
+
+#define IRL_PROFILE_START(T) CIRL_Profiler<T>::start()
+#define IRL_PROFILE_BRANCH(T, b) CIRL_Profiler<T>::branch(b)
+#define IRL_PROFILE_STOP(T) CIRL_Profiler<T>::stop()
+
+#else
+#define IRL_PROFILE_START(T) do {} while (0)
+#define IRL_PROFILE_BRANCH(T, b) do {} while (0)
+#define IRL_PROFILE_STOP(T) do {} while (0)
+#endif
+
+// Decoding branches of an interrupt
+enum IRL_Branch : uint8_t
+{
+    // Timeout, the reading is reset
+    IRL_BRANCH_TIMEOUT,
+    // Wrong lead, the reading is reset
+    IRL_BRANCH_LEAD,
+    // Holding lead (repeat signal)
+    IRL_BRANCH_HOLDING,
+    // A single data bit
+    IRL_BRANCH_DATA,
+    // Last bit, including the checksum and saving the frame
+    IRL_BRANCH_LAST,
+    // Everything else: a valid lead, ignored or blocked edges
+    IRL_BRANCH_OTHER,
+    IRL_BRANCH_COUNT
+};
+
+struct IRL_Profile_t
+{
+    uint16_t count;
+    uint16_t min;
+    uint16_t max;
+    uint16_t histogram[IRL_PROFILER_BUCKETS];
+};
+
+#ifdef IRL_PROFILER
+//==============================================================================
+// IRL_Profiler Class
+//==============================================================================
+
+template<class T>
+class CIRL_Profiler
+{
+public:
+    // Starts the cycle counter and measures its overhead
+    static inline void begin(void);
+
+    // Copy of a single branch, interrupts are disabled for the copy
+    static inline IRL_Profile_t profile(uint8_t branch);
+    static inline void reset(void);
+
+    // Prints all branches to a Print object, for example Serial
+    template<class P>
+    static void report(P &out);
+
+    // Called by the decoders
+    static inline void start(void);
+    static inline void branch(uint8_t b);
+    static inline void stop(void);
+
+protected:
+    static uint16_t mstart;
+    static uint16_t moverhead;
+    static uint8_t mbranch;
+    static IRL_Profile_t mprofiles[IRL_BRANCH_COUNT];
+};
+
+
+//==============================================================================
+// Static Data
+//==============================================================================
+
+template<class T>
+uint16_t CIRL_Profiler<T>::mstart = 0;
+template<class T>
+uint16_t CIRL_Profiler<T>::moverhead = 0;
+template<class T>
+uint8_t CIRL_Profiler<T>::mbranch = IRL_BRANCH_OTHER;
+template<class T>
+IRL_Profile_t CIRL_Profiler<T>::mprofiles[IRL_BRANCH_COUNT];
+
+
+//==============================================================================
+// CIRL_Profiler Implementation
+//==============================================================================
+
+template<class T>
+void CIRL_Profiler<T>::begin(void)
+{
+#if defined(ARDUINO_ARCH_AVR) || defined(DMBS_ARCH_AVR8)
+    // Run Timer1 with the CPU clock
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10);
+#endif
+
+    // Reading the counter twice is the minimum of every measurement
+    moverhead = 0xFFFF;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        uint16_t first = IRL_PROFILER_CYCLES();
+        uint16_t overhead = IRL_PROFILER_CYCLES() - first;
+        if (overhead < moverhead) {
+            moverhead = overhead;
+        }
+    }
+    reset();
+}
+
+
+template<class T>
+IRL_Profile_t CIRL_Profiler<T>::profile(uint8_t branch)
+{
+    IRL_Profile_t ret;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        ret = mprofiles[branch];
+    }
+    return ret;
+}
+
+
+template<class T>
+void CIRL_Profiler<T>::reset(void)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        for (uint8_t i = 0; i < IRL_BRANCH_COUNT; i++)
+        {
+            mprofiles[i].count = 0;
+            mprofiles[i].min = 0xFFFF;
+            mprofiles[i].max = 0;
+            for (uint8_t j = 0; j < IRL_PROFILER_BUCKETS; j++) {
+                mprofiles[i].histogram[j] = 0;
+            }
+        }
+    }
+}
+
+
+template<class T>
+template<class P>
+void CIRL_Profiler<T>::report(P &out)
+{
+    static const char * const names[IRL_BRANCH_COUNT] = {
+        "Timeout", "Lead", "Holding", "Data", "Last", "Other"
+    };
+
+    for (uint8_t i = 0; i < IRL_BRANCH_COUNT; i++)
+    {
+        IRL_Profile_t p = profile(i);
+        if (!p.count) {
+            continue;
+        }
+        out.print(names[i]);
+        out.print(" count: ");
+        out.print(p.count);
+        out.print(" min: ");
+        out.print(p.min);
+        out.print(" max: ");
+        out.print(p.max);
+        out.print(" histogram:");
+        for (uint8_t j = 0; j < IRL_PROFILER_BUCKETS; j++)
+        {
+            out.print(' ');
+            out.print(p.histogram[j]);
+        }
+        out.println();
+    }
+}
+
+
+template<class T>
+void CIRL_Profiler<T>::start(void)
+{
+    mbranch = IRL_BRANCH_OTHER;
+    mstart = IRL_PROFILER_CYCLES();
+}
+
+
+template<class T>
+void CIRL_Profiler<T>::branch(uint8_t b)
+{
+    mbranch = b;
+}
+
+
+template<class T>
+void CIRL_Profiler<T>::stop(void)
+{
+    uint16_t cycles = IRL_PROFILER_CYCLES() - mstart;
+    cycles = cycles > moverhead ? cycles - moverhead : 0;
+
+    // Counters saturate at 0xFFFF
+    IRL_Profile_t &p = mprofiles[mbranch];
+    if (p.count == 0xFFFF) {
+        return;
+    }
+    p.count++;
+    if (cycles < p.min) {
+        p.min = cycles;
+    }
+    if (cycles > p.max) {
+        p.max = cycles;
+    }
+    uint16_t bucket = cycles >> IRL_PROFILER_SHIFT;
+    if (bucket >= IRL_PROFILER_BUCKETS) {
+        bucket = IRL_PROFILER_BUCKETS - 1;
+    }
+    p.histogram[bucket]++;
+}
+#endif
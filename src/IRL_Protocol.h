@@ -26,6 +26,44 @@ THE SOFTWARE.
 
 #include "IRL_Platform.h"
 
+// Frame queue: the decoder saves every new frame in a queue and starts the
+// next reading immediately, instead of blocking until read() is called.
+// Define the number of frames (power of two, max 128) before including IRLremote.
+//#define IRL_FRAME_QUEUE 4
+
+#ifdef IRL_FRAME_QUEUE
+static_assert(IRL_FRAME_QUEUE >= 2 && IRL_FRAME_QUEUE <= 128 &&
+              (IRL_FRAME_QUEUE & (IRL_FRAME_QUEUE - 1)) == 0,
+              "IRL_FRAME_QUEUE must be a power of two between 2 and 128");
+#endif
+
+// Decoder statistics: every decoder counts its frames and errors.
+// Define before including IRLremote, compiled out otherwise.
+//#define IRL_STATISTICS
+
+// Counters saturate at 0xFFFF
+struct IRL_Statistics_t
+{
+    // Valid frames, including holding frames
+    uint16_t frames;
+    // Frames with a wrong checksum
+    uint16_t checksum;
+    // Readings that were reset because of a wrong lead
+    uint16_t lead;
+    // Holding frames too long after the last valid frame (limitRepeat)
+    uint16_t repeat;
+    // Timeouts in the middle of a frame
+    uint16_t timeout;
+    // Frames that were not decoded because the last frame was not read yet
+    uint16_t dropped;
+};
+
+#ifdef IRL_STATISTICS
+#define IRL_STATISTIC(T, counter) T::statistic(T::mstatistics.counter)
+#else
+#define IRL_STATISTIC(T, counter) do {} while (0)
+#endif
+
 //==============================================================================
 // IRL_Protocol Class
 //==============================================================================
@@ -37,13 +75,81 @@ public:
     // User API to access library data
     Protocol_data_t read(void);
 
+    // Event time of the frame that was returned by the last read().
+    // Saved together with the data, lastEvent() might already be newer.
+    inline uint32_t readTime(void);
+
+#ifdef IRL_FRAME_QUEUE
+    // Number of frames that were dropped because the queue was full
+    inline uint16_t overflows(void);
+#endif
+
+#ifdef IRL_STATISTICS
+    // Copy of the decoder statistics, interrupts are disabled for the copy
+    inline IRL_Statistics_t statistics(void);
+    inline void resetStatistics(void);
+#endif
+
 protected:
     // Interface that is required to be implemented
-    //inline Nec_data_t getData(void);
+    //static inline Nec_data_t getData(void);
     //inline void resetReading(void);
+
+#ifdef IRL_STATISTICS
+    static inline void statistic(volatile uint16_t &counter);
+
+    // Counts a dropped frame if an edge after a timeout is ignored,
+    // because the last frame was not read yet
+    static inline void blocked(uint32_t time, uint32_t limitTimeout);
+
+    static volatile IRL_Statistics_t mstatistics;
+    static uint32_t mblockedTime;
+#endif
+
+#ifdef IRL_FRAME_QUEUE
+    // Saves the current frame with the last event time
+    static inline void queueFrame(void);
+    static inline bool queueAvailable(void);
+
+    // Single producer (decoder), single consumer (read) queue
+    static Protocol_data_t mframes[IRL_FRAME_QUEUE];
+    static uint32_t mframeTimes[IRL_FRAME_QUEUE];
+    static volatile uint8_t mframeHead;
+    static volatile uint8_t mframeTail;
+    static volatile uint16_t mframeOverflows;
+#endif
+    static uint32_t mreadTime;
 };
 
 
+//==============================================================================
+// Static Data
+//==============================================================================
+
+#ifdef IRL_STATISTICS
+template<class T, class Protocol_data_t>
+volatile IRL_Statistics_t CIRL_Protocol<T, Protocol_data_t>::mstatistics = { 0, 0, 0, 0, 0, 0 };
+template<class T, class Protocol_data_t>
+uint32_t CIRL_Protocol<T, Protocol_data_t>::mblockedTime = 0;
+#endif
+
+#ifdef IRL_FRAME_QUEUE
+
+template<class T, class Protocol_data_t>
+Protocol_data_t CIRL_Protocol<T, Protocol_data_t>::mframes[IRL_FRAME_QUEUE];
+template<class T, class Protocol_data_t>
+uint32_t CIRL_Protocol<T, Protocol_data_t>::mframeTimes[IRL_FRAME_QUEUE] = { 0 };
+template<class T, class Protocol_data_t>
+volatile uint8_t CIRL_Protocol<T, Protocol_data_t>::mframeHead = 0;
+template<class T, class Protocol_data_t>
+volatile uint8_t CIRL_Protocol<T, Protocol_data_t>::mframeTail = 0;
+template<class T, class Protocol_data_t>
+volatile uint16_t CIRL_Protocol<T, Protocol_data_t>::mframeOverflows = 0;
+#endif
+template<class T, class Protocol_data_t>
+uint32_t CIRL_Protocol<T, Protocol_data_t>::mreadTime = 0;
+
+
 //==============================================================================
 // CIRL_Protocol Implementation
 //==============================================================================
@@ -54,26 +160,160 @@ Protocol_data_t CIRL_Protocol<T, Protocol_data_t>::read(void)
     // If nothing was received return an empty struct
     Protocol_data_t retdata = Protocol_data_t();
 
-    // Disable interrupts while accessing volatile data
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#if defined(IRL_FRAME_QUEUE)
+    // Check for new frames (and decode or detect timeouts if required)
+    if (static_cast<T*>(this)->available())
     {
-        // Check and get data if we have new.
-        if (static_cast<T*>(this)->available())
-        {
-            // Set last ISR to current time.
-            // This is required to not trigger a timeout afterwards
-            // and read corrupted data. This might happen
-            // if the reading loop is too slow.
-            static_cast<T*>(this)->mlastTime = micros();
+        // The decoder never writes to the oldest frame, no need to block it
+        uint8_t tail = mframeTail;
+        retdata = mframes[tail % IRL_FRAME_QUEUE];
+        mreadTime = mframeTimes[tail % IRL_FRAME_QUEUE];
+        IRL_MEMORY_BARRIER();
+        mframeTail = tail + 1;
+    }
+#elif defined(IRL_DEFERRED_DECODE)
+    // Decoding runs in the main loop, the interrupt never touches the data.
+    // The time keeps running while the data is unread, no need to reset it.
+    if (static_cast<T*>(this)->available())
+    {
+        retdata = static_cast<T*>(this)->getData();
+        mreadTime = T::mlastEvent;
+        static_cast<T*>(this)->resetReading();
+    }
+#else
+    // Check and get data if we have new.
+    // The interrupt does not change a recognized frame until it was read,
+    // so the data is copied without disabling interrupts.
+    if (static_cast<T*>(this)->available())
+    {
+        // Save the protocol data and its event time
+        retdata = static_cast<T*>(this)->getData();
+        mreadTime = T::mlastEvent;
 
-            // Save the protocol data
-            retdata = static_cast<T*>(this)->getData();
+        // Set last ISR to current time.
+        // This is required to not trigger a timeout afterwards
+        // and read corrupted data. This might happen
+        // if the reading loop is too slow.
+        uint32_t time = T::Timebase::now();
 
-            // Reset reading
+        // Only the reset of the decoding state is atomic
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            static_cast<T*>(this)->mlastTime = time;
             static_cast<T*>(this)->resetReading();
         }
     }
+#endif
 
     // Return the new protocol information to the user
     return retdata;
 }
+
+
+template<class T, class Protocol_data_t>
+uint32_t CIRL_Protocol<T, Protocol_data_t>::readTime(void)
+{
+    return mreadTime;
+}
+
+
+#ifdef IRL_FRAME_QUEUE
+template<class T, class Protocol_data_t>
+uint16_t CIRL_Protocol<T, Protocol_data_t>::overflows(void)
+{
+    uint16_t ret;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        ret = mframeOverflows;
+    }
+    return ret;
+}
+
+
+/*
+ * Saves the decoded data and the event time as new frame.
+ * Called by the decoder, the reading must be restarted afterwards.
+ */
+template<class T, class Protocol_data_t>
+void CIRL_Protocol<T, Protocol_data_t>::queueFrame(void)
+{
+    // Drop the new frame if the queue is full
+    uint8_t head = mframeHead;
+    if (uint8_t(head - mframeTail) >= IRL_FRAME_QUEUE)
+    {
+        if (mframeOverflows != 0xFFFF) {
+            mframeOverflows++;
+        }
+        IRL_STATISTIC(T, dropped);
+        return;
+    }
+
+    mframes[head % IRL_FRAME_QUEUE] = T::getData();
+    mframeTimes[head % IRL_FRAME_QUEUE] = T::mlastEvent;
+
+    // Publish the new frame
+    IRL_MEMORY_BARRIER();
+    mframeHead = head + 1;
+}
+
+
+template<class T, class Protocol_data_t>
+bool CIRL_Protocol<T, Protocol_data_t>::queueAvailable(void)
+{
+    return mframeHead != mframeTail;
+}
+#endif
+
+
+#ifdef IRL_STATISTICS
+template<class T, class Protocol_data_t>
+IRL_Statistics_t CIRL_Protocol<T, Protocol_data_t>::statistics(void)
+{
+    IRL_Statistics_t ret;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        ret.frames = mstatistics.frames;
+        ret.checksum = mstatistics.checksum;
+        ret.lead = mstatistics.lead;
+        ret.repeat = mstatistics.repeat;
+        ret.timeout = mstatistics.timeout;
+        ret.dropped = mstatistics.dropped;
+    }
+    return ret;
+}
+
+
+template<class T, class Protocol_data_t>
+void CIRL_Protocol<T, Protocol_data_t>::resetStatistics(void)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        mstatistics.frames = 0;
+        mstatistics.checksum = 0;
+        mstatistics.lead = 0;
+        mstatistics.repeat = 0;
+        mstatistics.timeout = 0;
+        mstatistics.dropped = 0;
+    }
+}
+
+
+template<class T, class Protocol_data_t>
+void CIRL_Protocol<T, Protocol_data_t>::statistic(volatile uint16_t &counter)
+{
+    if (counter != 0xFFFF) {
+        counter++;
+    }
+}
+
+
+template<class T, class Protocol_data_t>
+void CIRL_Protocol<T, Protocol_data_t>::blocked(uint32_t time,
+                                                uint32_t limitTimeout)
+{
+    if ((time - mblockedTime) >= limitTimeout) {
+        statistic(mstatistics.dropped);
+    }
+    mblockedTime = time;
+}
+#endif
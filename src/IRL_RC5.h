@@ -0,0 +1,157 @@
+/*
+Copyright (c) 2014-2018 NicoHood
+See the readme for credit to other people.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Include guard
+#pragma once
+
+#include "IRL_Receive.h"
+#include "IRL_Time.h"
+#include "IRL_Protocol.h"
+#include "IRL_Decode.h"
+#include "IRL_IRP.h"
+
+//==============================================================================
+// Protocol Definitions
+//==============================================================================
+
+// RC5
+// IRP notation:
+// {36k,msb,889}<1,-1|-1,1>(1,~F:1:6,T:1,D:5,F:6,^114m)+
+// Bi-phase (Manchester) logic
+#define RC5_IRP                 "{36k,msb,889}<1,-1|-1,1>(1,~F:1:6,T:1,D:5,F:6,^114m)+"
+#define RC5_HZ                  CIRL_IRP::frequency(RC5_IRP)
+#define RC5_PULSE               CIRL_IRP::unit(RC5_IRP)
+#define RC5_ADDRESS_LENGTH      5
+#define RC5_COMMAND_LENGTH      7
+// Start bit, field bit (inverted command bit 6), toggle, address, command
+#define RC5_DATA_LENGTH         14
+#define RC5_BLOCKS              ((RC5_DATA_LENGTH + 7) / 8)
+// Frames are repeated every 114ms (start to start)
+#define RC5_TIMESPAN_HOLDING    CIRL_IRP::timing(RC5_IRP).extent
+#define RC5_TIMEOUT             (RC5_TIMESPAN_HOLDING - \
+                                RC5_DATA_LENGTH * 2 * RC5_PULSE)
+
+// Decoding limits
+// Marks and spaces are 1 or 2 units, there is no lead
+#define RC5_LIMIT_UNIT1         (RC5_PULSE * 3 / 2)
+#define RC5_LIMIT_UNIT2         (RC5_PULSE * 5 / 2)
+#define RC5_LIMIT_UNIT3         RC5_LIMIT_UNIT2
+#define RC5_LIMIT_TIMEOUT       ((RC5_TIMEOUT + 2 * RC5_PULSE) / 2)
+
+static_assert(CIRL_IRP::valid(RC5_IRP), "Invalid IRP notation: " RC5_IRP);
+
+/*
+RC5 bit coding:
+
+*  Logical 0: mark + space   |   |---|
+*                            |---|   |
+*  Logical 1: space + mark   |---|   |
+*                            |   |---|
+*
+*  1 Pulse:   |--| Half bit
+*  1.5 Pulses |---| limitUnit1
+*  2 Pulses:  |----| Two half bits with the same level
+*  2.5 Pulses |-----| limitUnit2, longer marks/spaces are errors
+*
+*  The first half of the start bit S1 (always 1) is the idle space.
+*  The toggle bit changes with every new button press.
+*/
+
+typedef uint8_t RC5_address_t;
+typedef uint8_t RC5_command_t;
+
+// Struct that is returned by the read() function
+struct RC5_data_t
+{
+    RC5_address_t address;
+    RC5_command_t command;
+    // Changes with every new button press, equal while holding
+    uint8_t toggle;
+};
+
+//==============================================================================
+// RC5 Decoding Class
+//==============================================================================
+
+// Each instance number has its own decoding state and interrupt function.
+// Use different numbers (for example the pin number) for multiple receivers.
+template<uint8_t instance>
+class CRC5Instance : public CIRL_Receive<CRC5Instance<instance>>,
+                     public CIRL_Time<CRC5Instance<instance>>,
+                     public CIRL_Protocol<CRC5Instance<instance>, RC5_data_t>,
+                     public CIRL_DecodeBiphase<CRC5Instance<instance>, RC5_BLOCKS>
+{
+protected:
+    static constexpr uint32_t timespanEvent = RC5_TIMESPAN_HOLDING;
+    static constexpr uint32_t limitTimeout = RC5_LIMIT_TIMEOUT;
+    static constexpr uint32_t limitLeadMark = 0;
+    static constexpr uint32_t limitLeadSpace = 0;
+    static constexpr uint32_t limitUnit1 = RC5_LIMIT_UNIT1;
+    static constexpr uint32_t limitUnit2 = RC5_LIMIT_UNIT2;
+    static constexpr uint32_t limitUnit3 = RC5_LIMIT_UNIT3;
+    static constexpr uint8_t bits = RC5_DATA_LENGTH;
+    static constexpr uint8_t doubleBit = 0xFF;
+    static constexpr bool markFirst = false;
+
+    friend CIRL_Receive<CRC5Instance>;
+    friend CIRL_Time<CRC5Instance>;
+    template<class...> friend class CIRL_Multi;
+    friend CIRL_Protocol<CRC5Instance, RC5_data_t>;
+    friend CIRL_DecodeBiphase<CRC5Instance, RC5_BLOCKS>;
+
+    // Protocol interface functions
+    static inline RC5_data_t getData(void);
+    static inline bool checksum(void);
+
+    // Decoding buffer of this instance
+    using CIRL_DecodeBiphase<CRC5Instance, RC5_BLOCKS>::data;
+};
+
+// Default receiver
+typedef CRC5Instance<0> CRC5;
+
+
+//==============================================================================
+// RC5 Decoding Implementation
+//==============================================================================
+
+template<uint8_t instance>
+RC5_data_t CRC5Instance<instance>::getData(void) {
+    // 14 bits, MSB first: S1 S2 T A4..A0 C5..C0
+    uint16_t bits = (((uint16_t)data[0] << 8) | data[1]) >> 2;
+
+    RC5_data_t retdata;
+    retdata.address = (bits >> 6) & 0x1F;
+    retdata.command = (bits & 0x3F) | ((~bits >> 6) & 0x40);
+    retdata.toggle = (bits >> 11) & 0x01;
+    return retdata;
+}
+
+
+template<uint8_t instance>
+bool CRC5Instance<instance>::checksum(void) {
+    // RC5 has no checksum. The first half of start bit S1 is the idle space,
+    // so S1 always decodes as 1. S2 is the inverted command bit 6 and valid
+    // with either value. The bit count is fixed, the decoder stops after it.
+    return true;
+}
@@ -0,0 +1,163 @@
+/*
+Copyright (c) 2014-2018 NicoHood
+See the readme for credit to other people.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Include guard
+#pragma once
+
+#include "IRL_Receive.h"
+#include "IRL_Time.h"
+#include "IRL_Protocol.h"
+#include "IRL_Decode.h"
+#include "IRL_IRP.h"
+
+//==============================================================================
+// Protocol Definitions
+//==============================================================================
+
+// RC6 (Mode 0)
+// IRP notation:
+// {36k,444,msb}<-1,1|1,-1>(6,-2,1:1,0:3,<-2,2|2,-2>(T:1),D:8,F:8,^107m)+
+// Lead + Bi-phase (Manchester) logic
+#define RC6_IRP                 "{36k,444,msb}<-1,1|1,-1>(6,-2,1:1,0:3,<-2,2|2,-2>(T:1),D:8,F:8,^107m)+"
+#define RC6_HZ                  CIRL_IRP::frequency(RC6_IRP)
+#define RC6_PULSE               CIRL_IRP::unit(RC6_IRP)
+#define RC6_ADDRESS_LENGTH      8
+#define RC6_COMMAND_LENGTH      8
+// Start bit, 3 mode bits, toggle (double width), address, command
+#define RC6_DATA_LENGTH         21
+#define RC6_BLOCKS              ((RC6_DATA_LENGTH + 7) / 8)
+#define RC6_TOGGLE_BIT          4
+#define RC6_MARK_LEAD           CIRL_IRP::timing(RC6_IRP).markLead
+#define RC6_SPACE_LEAD          CIRL_IRP::timing(RC6_IRP).spaceLead
+// Frames are repeated every 107ms (start to start)
+#define RC6_TIMESPAN_HOLDING    CIRL_IRP::timing(RC6_IRP).extent
+#define RC6_TIMEOUT             (RC6_TIMESPAN_HOLDING - RC6_MARK_LEAD - \
+                                RC6_SPACE_LEAD - \
+                                (RC6_DATA_LENGTH + 1) * 2 * RC6_PULSE)
+
+// Decoding limits
+// Marks and spaces are 1 to 3 units, the toggle bit halves are 2 units
+#define RC6_LIMIT_UNIT1         (RC6_PULSE * 3 / 2)
+#define RC6_LIMIT_UNIT2         (RC6_PULSE * 5 / 2)
+#define RC6_LIMIT_UNIT3         (RC6_PULSE * 7 / 2)
+#define RC6_LIMIT_LEAD_MARK     (RC6_PULSE * 9 / 2)
+#define RC6_LIMIT_LEAD_SPACE    RC6_LIMIT_UNIT2
+#define RC6_LIMIT_TIMEOUT       ((RC6_TIMEOUT + RC6_MARK_LEAD) / 2)
+
+static_assert(CIRL_IRP::valid(RC6_IRP), "Invalid IRP notation: " RC6_IRP);
+
+/*
+RC6 bit coding:
+
+*  Logical 0: space + mark   |---|   |
+*                            |   |---|
+*  Logical 1: mark + space   |   |---|
+*                            |---|   |
+*
+*  1 Pulse:   |--| Half bit
+*  2 Pulses:  |----| Lead space, toggle bit half
+*  4.5 Pulses |---------| limitLeadMark
+*  6 Pulses:  |------------| Lead mark
+*
+*  The toggle bit halves are 2 units long, so marks and spaces are
+*  1 to 3 units. The toggle bit changes with every new button press.
+*/
+
+typedef uint8_t RC6_address_t;
+typedef uint8_t RC6_command_t;
+
+// Struct that is returned by the read() function
+struct RC6_data_t
+{
+    RC6_address_t address;
+    RC6_command_t command;
+    // Changes with every new button press, equal while holding
+    uint8_t toggle;
+};
+
+//==============================================================================
+// RC6 Decoding Class
+//==============================================================================
+
+// Each instance number has its own decoding state and interrupt function.
+// Use different numbers (for example the pin number) for multiple receivers.
+template<uint8_t instance>
+class CRC6Instance : public CIRL_Receive<CRC6Instance<instance>>,
+                     public CIRL_Time<CRC6Instance<instance>>,
+                     public CIRL_Protocol<CRC6Instance<instance>, RC6_data_t>,
+                     public CIRL_DecodeBiphase<CRC6Instance<instance>, RC6_BLOCKS>
+{
+protected:
+    static constexpr uint32_t timespanEvent = RC6_TIMESPAN_HOLDING;
+    static constexpr uint32_t limitTimeout = RC6_LIMIT_TIMEOUT;
+    static constexpr uint32_t limitLeadMark = RC6_LIMIT_LEAD_MARK;
+    static constexpr uint32_t limitLeadSpace = RC6_LIMIT_LEAD_SPACE;
+    static constexpr uint32_t limitUnit1 = RC6_LIMIT_UNIT1;
+    static constexpr uint32_t limitUnit2 = RC6_LIMIT_UNIT2;
+    static constexpr uint32_t limitUnit3 = RC6_LIMIT_UNIT3;
+    static constexpr uint8_t bits = RC6_DATA_LENGTH;
+    static constexpr uint8_t doubleBit = RC6_TOGGLE_BIT;
+    static constexpr bool markFirst = true;
+
+    friend CIRL_Receive<CRC6Instance>;
+    friend CIRL_Time<CRC6Instance>;
+    template<class...> friend class CIRL_Multi;
+    friend CIRL_Protocol<CRC6Instance, RC6_data_t>;
+    friend CIRL_DecodeBiphase<CRC6Instance, RC6_BLOCKS>;
+
+    // Protocol interface functions
+    static inline RC6_data_t getData(void);
+    static inline bool checksum(void);
+
+    // Decoding buffer of this instance
+    using CIRL_DecodeBiphase<CRC6Instance, RC6_BLOCKS>::data;
+};
+
+// Default receiver
+typedef CRC6Instance<0> CRC6;
+
+
+//==============================================================================
+// RC6 Decoding Implementation
+//==============================================================================
+
+template<uint8_t instance>
+RC6_data_t CRC6Instance<instance>::getData(void) {
+    // 21 bits, MSB first: S M2..M0 T A7..A0 C7..C0
+    uint32_t bits = (((uint32_t)data[0] << 16) |
+                     ((uint32_t)data[1] << 8) |
+                     ((uint32_t)data[2])) >> 3;
+
+    RC6_data_t retdata;
+    retdata.address = bits >> 8;
+    retdata.command = bits;
+    retdata.toggle = (bits >> 16) & 0x01;
+    return retdata;
+}
+
+
+template<uint8_t instance>
+bool CRC6Instance<instance>::checksum(void) {
+    // RC6 has no checksum, check start bit 1 and mode 0
+    return (data[0] & 0xF0) == 0x80;
+}
@@ -28,6 +28,8 @@ THE SOFTWARE.
 #include <Arduino.h> // pinMode()
 #endif
 
+#include "IRL_Platform.h"
+
 #ifdef DMBS_MODULE_BOARD
 #include "board_pins.h"
 #endif
@@ -48,7 +50,7 @@ template<class T>
 class CIRL_Receive
 {
 public:
-#ifdef ARDUINO
+#if defined(ARDUINO) || defined(IRL_HOST)
     // Attach the interrupt so IR signals are detected
     inline bool begin(uint8_t pin);
     inline bool end(uint8_t pin);
@@ -72,7 +74,7 @@ template<class T>
 template<uint8_t pin>
 bool CIRL_Receive<T>::begin(void)
 {
-#ifdef ARDUINO
+#if defined(ARDUINO) || defined(IRL_HOST)
     return begin(pin);
 #else
     // Set pin to INPUT_PULLUP
@@ -91,10 +93,14 @@ bool CIRL_Receive<T>::begin(void)
 #endif
 }
 
-#ifdef ARDUINO
+#if defined(ARDUINO) || defined(IRL_HOST)
 template<class T>
 bool CIRL_Receive<T>::begin(uint8_t pin)
 {
+#ifdef IRL_TIMER_CAPTURE
+    // The timer captures the edges on its input capture pin
+    return CIRL_TimerCapture::begin(pin, T::interrupt, T::interruptMode);
+#else
     // Get pin ready for reading.
     pinMode(pin, INPUT_PULLUP);
 
@@ -114,6 +120,7 @@ bool CIRL_Receive<T>::begin(uint8_t pin)
 
     // Return an error if none of them work (pin has no Pin(Change)Interrupt)
     return false;
+#endif
 }
 #endif
 
@@ -121,7 +128,7 @@ template<class T>
 template<uint8_t pin>
 bool CIRL_Receive<T>::end(void)
 {
-#ifdef ARDUINO
+#if defined(ARDUINO) || defined(IRL_HOST)
     return end(pin);
 #else
     // Disable pullup.
@@ -139,10 +146,13 @@ bool CIRL_Receive<T>::end(void)
 #endif
 }
 
-#ifdef ARDUINO
+#if defined(ARDUINO) || defined(IRL_HOST)
 template<class T>
 bool CIRL_Receive<T>::end(uint8_t pin)
 {
+#ifdef IRL_TIMER_CAPTURE
+    return CIRL_TimerCapture::end(pin);
+#else
     // Disable pullup.
     pinMode(pin, INPUT);
 
@@ -162,5 +172,6 @@ bool CIRL_Receive<T>::end(uint8_t pin)
 
     // Return an error if none of them work (pin has no Pin(Change)Interrupt)
     return false;
+#endif
 }
 #endif
@@ -0,0 +1,380 @@
+/*
+Copyright (c) 2014-2018 NicoHood
+See the readme for credit to other people.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Include guard
+#pragma once
+
+#include "IRL_Platform.h"
+#include "IRL_IRP.h"
+
+// Length of the internal buffer for write(timing, data).
+// Lead + space, mark and space for every bit, end mark.
+#ifndef IRL_SEND_LENGTH
+#define IRL_SEND_LENGTH 99
+#endif
+
+typedef void(*IRL_SendCallback)(void);
+
+//==============================================================================
+// IRL_Send Class
+//==============================================================================
+
+/*
+ * Asynchronous sender. A schedule of mark/space durations is sent from a
+ * timer compare interrupt, the carrier is generated by hardware PWM.
+ * write() returns immediately, sending() or a callback report completion.
+ * Interrupts stay enabled while sending.
+ */
+template<class T>
+class CIRL_Send
+{
+public:
+    // Setup the timer and the carrier pin
+    static inline void begin(void);
+    static inline void end(void);
+
+    // Send marks and spaces (in microseconds), starting with a mark.
+    // The durations are not copied and must stay valid while sending.
+    // The gap is a space after the last duration, sending() is true until
+    // the gap has passed. Returns false if the sender is busy.
+    static bool write(const uint16_t* durations, uint8_t length,
+                      uint32_t gap, uint32_t hz,
+                      IRL_SendCallback callback = nullptr);
+
+    // Encode and send a frame or a holding frame of an IRP timing table
+    static bool write(const IRL_Timing_t &timing, const uint8_t* data,
+                      IRL_SendCallback callback = nullptr);
+    static bool writeHolding(const IRL_Timing_t &timing,
+                             IRL_SendCallback callback = nullptr);
+
+    // Returns true while a schedule is sent
+    static inline bool sending(void);
+
+    // Timer compare interrupt, called by the platform implementation
+    static void interrupt(void);
+
+protected:
+    static inline void next(uint32_t duration);
+
+    // Current schedule
+    static const uint16_t* mdurations;
+    static uint8_t mlength;
+    static uint8_t mindex;
+    static uint32_t mgap;
+    static uint32_t mremaining;
+    static volatile bool msending;
+    static IRL_SendCallback mcallback;
+
+    // Buffer for encoded frames
+    static uint16_t mbuffer[IRL_SEND_LENGTH];
+
+    // Interface that is required to be implemented
+    //static inline void timerBegin(void);
+    //static inline void timerEnd(void);
+    //static inline void timerStart(void);
+    //static inline void timerNext(uint16_t duration);
+    //static inline void timerStop(void);
+    //static inline void carrierFrequency(uint32_t hz);
+    //static inline void carrier(bool on);
+    //static constexpr uint16_t maxDuration = VALUE;
+};
+
+
+//==============================================================================
+// Static Data
+//==============================================================================
+
+template<class T> const uint16_t* CIRL_Send<T>::mdurations = nullptr;
+template<class T> uint8_t CIRL_Send<T>::mlength = 0;
+template<class T> uint8_t CIRL_Send<T>::mindex = 0;
+template<class T> uint32_t CIRL_Send<T>::mgap = 0;
+template<class T> uint32_t CIRL_Send<T>::mremaining = 0;
+template<class T> volatile bool CIRL_Send<T>::msending = false;
+template<class T> IRL_SendCallback CIRL_Send<T>::mcallback = nullptr;
+template<class T> uint16_t CIRL_Send<T>::mbuffer[IRL_SEND_LENGTH] = { 0 };
+
+
+//==============================================================================
+// CIRL_Send Implementation
+//==============================================================================
+
+template<class T>
+void CIRL_Send<T>::begin(void)
+{
+    T::carrier(false);
+    T::timerBegin();
+}
+
+
+template<class T>
+void CIRL_Send<T>::end(void)
+{
+    T::timerStop();
+    T::carrier(false);
+    T::timerEnd();
+    msending = false;
+}
+
+
+template<class T>
+bool CIRL_Send<T>::write(const uint16_t* durations, uint8_t length,
+                         uint32_t gap, uint32_t hz,
+                         IRL_SendCallback callback)
+{
+    if (msending) {
+        return false;
+    }
+
+    mdurations = durations;
+    mlength = length;
+    mindex = 0;
+    mgap = gap;
+    mremaining = 0;
+    mcallback = callback;
+    msending = true;
+    T::carrierFrequency(hz);
+
+    // Start the first mark now, the interrupt continues with the next one
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        T::timerStart();
+        interrupt();
+    }
+    return true;
+}
+
+
+template<class T>
+bool CIRL_Send<T>::write(const IRL_Timing_t &timing, const uint8_t* data,
+                         IRL_SendCallback callback)
+{
+    // The buffer is in use while sending
+    if (msending || (3 + timing.bits * 2) > IRL_SEND_LENGTH) {
+        return false;
+    }
+
+    uint8_t length = CIRL_IRP::encode(timing, data, mbuffer);
+    return write(mbuffer, length, timing.spaceEnd, timing.hz, callback);
+}
+
+
+template<class T>
+bool CIRL_Send<T>::writeHolding(const IRL_Timing_t &timing,
+                                IRL_SendCallback callback)
+{
+    if (msending || !timing.markHolding) {
+        return false;
+    }
+
+    uint8_t length = CIRL_IRP::encodeHolding(timing, mbuffer);
+    return write(mbuffer, length, timing.spaceEndHolding, timing.hz, callback);
+}
+
+
+template<class T>
+bool CIRL_Send<T>::sending(void) {
+    return msending;
+}
+
+
+/*
+ * Called when the current mark or space has passed.
+ * Switches the carrier and schedules the next compare match.
+ */
+template<class T>
+void CIRL_Send<T>::interrupt(void)
+{
+    // Durations longer than the timer range are split
+    if (mremaining) {
+        next(mremaining);
+    }
+    // Even durations are marks, odd durations spaces
+    else if (mindex < mlength)
+    {
+        T::carrier((mindex % 2) == 0);
+        next(mdurations[mindex]);
+        mindex++;
+    }
+    // Space after the frame, so frames are not sent too early
+    else if (mgap)
+    {
+        T::carrier(false);
+        next(mgap);
+        mgap = 0;
+    }
+    // Done
+    else
+    {
+        T::carrier(false);
+        T::timerStop();
+        msending = false;
+        if (mcallback) {
+            mcallback();
+        }
+    }
+}
+
+
+template<class T>
+void CIRL_Send<T>::next(uint32_t duration)
+{
+    if (duration > T::maxDuration)
+    {
+        mremaining = duration - T::maxDuration;
+        duration = T::maxDuration;
+    }
+    else {
+        mremaining = 0;
+    }
+    T::timerNext(duration);
+}
+
+
+#if defined(IRL_HOST)
+//==============================================================================
+// Host Sender
+//==============================================================================
+
+/*
+ * Uses the timer of the host backend and records the output.
+ * See CIRL_Host::timeline*() and CIRL_Host::loopback().
+ */
+class CIRL_SendHost : public CIRL_Send<CIRL_SendHost>
+{
+protected:
+    friend CIRL_Send<CIRL_SendHost>;
+
+    static inline void timerBegin(void) {}
+    static inline void timerEnd(void) {}
+    static inline void timerStart(void) {
+        CIRL_Host::timer(CIRL_Host::micros(), nullptr);
+    }
+    static inline void timerNext(uint16_t duration) {
+        CIRL_Host::timer(CIRL_Host::timerTime() + duration, interrupt);
+    }
+    static inline void timerStop(void) {
+        CIRL_Host::stopTimer();
+    }
+    static inline void carrierFrequency(uint32_t hz) {
+        CIRL_Host::setFrequency(hz);
+    }
+    static inline void carrier(bool on) {
+        CIRL_Host::output(on);
+    }
+    static constexpr uint16_t maxDuration = 0xFFFF;
+};
+
+typedef CIRL_SendHost CIRL_Sender;
+
+// The host timer calls the interrupt function directly
+#define IRL_SEND_INTERRUPT
+
+#elif defined(ARDUINO_ARCH_AVR) && defined(TCCR2A) && defined(TCCR1A)
+//==============================================================================
+// AVR Timer Sender
+//==============================================================================
+
+/*
+ * Timer1 runs freely with a prescaler of 8, its compare match A interrupt
+ * switches the carrier. Timer2 generates the carrier on OC2B with 1/3 duty.
+ * Both timers are not usable by other libraries (Servo, tone()) while sending.
+ * Carrier pin: OC2B (Arduino Uno: pin 3, Mega: pin 9).
+ * Place IRL_SEND_INTERRUPT in a single source file, it defines the interrupt.
+ */
+class CIRL_SendTimer1 : public CIRL_Send<CIRL_SendTimer1>
+{
+protected:
+    friend CIRL_Send<CIRL_SendTimer1>;
+
+    // Timer1 ticks per microsecond with a prescaler of 8
+    static constexpr uint8_t ticks = F_CPU / 8000000UL;
+    static_assert(ticks >= 1, "IRL_Send requires F_CPU >= 8MHz");
+
+    static inline void timerBegin(void)
+    {
+        // OC2B output, low
+#if defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__)
+        DDRH |= (1 << DDH6);
+        PORTH &= ~(1 << PORTH6);
+#else
+        DDRD |= (1 << DDD3);
+        PORTD &= ~(1 << PORTD3);
+#endif
+
+        // Normal mode, prescaler 8
+        TCCR1A = 0;
+#ifdef IRL_TIMER_CAPTURE
+        // Keep the input capture settings
+        TCCR1B |= (1 << CS11);
+#else
+        TCCR1B = (1 << CS11);
+#endif
+    }
+    static inline void timerEnd(void) {
+        // With the input capture the timer keeps running as time source
+#ifndef IRL_TIMER_CAPTURE
+        TCCR1B = 0;
+#endif
+    }
+    static inline void timerStart(void)
+    {
+        OCR1A = TCNT1;
+        TIFR1 = (1 << OCF1A);
+        TIMSK1 |= (1 << OCIE1A);
+    }
+    static inline void timerNext(uint16_t duration) {
+        OCR1A += duration * ticks;
+    }
+    static inline void timerStop(void) {
+        TIMSK1 &= ~(1 << OCIE1A);
+    }
+    static inline void carrierFrequency(uint32_t hz)
+    {
+        // Fast PWM with OCR2A as top, prescaler 8
+        TCCR2A = (1 << WGM21) | (1 << WGM20);
+        TCCR2B = (1 << WGM22) | (1 << CS21);
+        OCR2A = (F_CPU / 8 / hz) - 1;
+        OCR2B = OCR2A / 3;
+    }
+    static inline void carrier(bool on)
+    {
+        // Connect OC2B to the PWM, the pin is low while disconnected
+        if (on) {
+            TCCR2A |= (1 << COM2B1);
+        }
+        else {
+            TCCR2A &= ~(1 << COM2B1);
+        }
+    }
+    static constexpr uint16_t maxDuration = 0xFFFF / ticks;
+};
+
+typedef CIRL_SendTimer1 CIRL_Sender;
+
+// Timer1 compare interrupt, only used in a single source file.
+// A definition in this header would be duplicated in every file including it.
+#define IRL_SEND_INTERRUPT \
+    ISR(TIMER1_COMPA_vect) { \
+        CIRL_SendTimer1::interrupt(); \
+    }
+#endif
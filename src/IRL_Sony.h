@@ -0,0 +1,171 @@
+/*
+Copyright (c) 2014-2018 NicoHood
+See the readme for credit to other people.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Include guard
+#pragma once
+
+#include "IRL_Receive.h"
+#include "IRL_Time.h"
+#include "IRL_Protocol.h"
+#include "IRL_Decode.h"
+#include "IRL_IRP.h"
+
+//==============================================================================
+// Protocol Definitions
+//==============================================================================
+
+// SONY 12, 15, 20
+// IRP notation:
+// {40k,600}<1,-1|2,-1>(4,-1,F:7,D:5,^45m)+
+// {40k,600}<1,-1|2,-1>(4,-1,F:7,D:8,^45m)+
+// {40k,600}<1,-1|2,-1>(4,-1,F:7,D:5,S:8,^45m)+
+// Lead + Mark logic
+#define SONY_IRP                "{40k,600}<1,-1|2,-1>(4,-1,F:7,D:5,^45m)+"
+#define SONY_HZ                 CIRL_IRP::frequency(SONY_IRP)
+#define SONY_PULSE              CIRL_IRP::unit(SONY_IRP)
+#define SONY_COMMAND_LENGTH     7
+#define SONY_ADDRESS_LENGTH_12  5
+#define SONY_ADDRESS_LENGTH_15  8
+#define SONY_ADDRESS_LENGTH_20  13
+#define SONY_DATA_LENGTH_12     (SONY_COMMAND_LENGTH + SONY_ADDRESS_LENGTH_12)
+#define SONY_DATA_LENGTH_15     (SONY_COMMAND_LENGTH + SONY_ADDRESS_LENGTH_15)
+#define SONY_DATA_LENGTH_20     (SONY_COMMAND_LENGTH + SONY_ADDRESS_LENGTH_20)
+#define SONY_BLOCKS             ((SONY_DATA_LENGTH_20 + 7) / 8)
+// 2 for lead + space, each bit has mark and space
+#define SONY_LENGTH             (2 + SONY_DATA_LENGTH_20 * 2)
+#define SONY_MARK_LEAD          CIRL_IRP::timing(SONY_IRP).markLead
+#define SONY_SPACE_LEAD         CIRL_IRP::timing(SONY_IRP).spaceLead
+#define SONY_MARK_ZERO          CIRL_IRP::timing(SONY_IRP).markZero
+#define SONY_MARK_ONE           CIRL_IRP::timing(SONY_IRP).markOne
+#define SONY_SPACE_ZERO         CIRL_IRP::timing(SONY_IRP).spaceZero
+#define SONY_SPACE_ONE          CIRL_IRP::timing(SONY_IRP).spaceOne
+#define SONY_LOGICAL_LEAD       (SONY_MARK_LEAD + SONY_SPACE_LEAD)
+#define SONY_LOGICAL_ONE        (SONY_MARK_ONE + SONY_SPACE_ONE)
+// Frames are repeated every 45ms (start to start), no holding function
+#define SONY_TIMESPAN_HOLDING   CIRL_IRP::timing(SONY_IRP).extent
+// Shortest gap: 20 bit frame with all ones
+#define SONY_TIMEOUT            (SONY_TIMESPAN_HOLDING - SONY_LOGICAL_LEAD - \
+                                SONY_DATA_LENGTH_20 * SONY_LOGICAL_ONE)
+
+// Decoding limits
+#define SONY_LIMIT_LOGIC        ((SONY_MARK_ONE + SONY_MARK_ZERO) / 2)
+#define SONY_LIMIT_LEAD         ((SONY_MARK_LEAD + SONY_MARK_ONE) / 2)
+#define SONY_LIMIT_SPACE        ((SONY_SPACE_ONE + SONY_MARK_ONE) / 2)
+#define SONY_LIMIT_TIMEOUT      ((SONY_TIMEOUT + SONY_MARK_LEAD) / 2)
+
+static_assert(CIRL_IRP::valid(SONY_IRP), "Invalid IRP notation: " SONY_IRP);
+
+/*
+Sony pulse demonstration:
+
+*---|                    |----|        |----|    |----/ ~ /----|
+*   |                    |    |        |    |    |             |
+*   |                    |    |        |    |    |             |
+*   |--------------------|    |--------|    |----|             |-
+*   |        Lead        |    | Log 1  |    |Log0|   Timeout    |
+
+*  1 Pulse:  |----| Logical 0 mark, every space
+*  2 Pulses: |--------| Logical 1 mark
+*  4 Pulses: |--------------------| Lead mark
+*  Frames with 12, 15 or 20 bits are repeated every 45ms.
+*  The length is detected by the gap (timeout) after the last mark.
+*/
+
+typedef uint16_t Sony_address_t;
+typedef uint8_t Sony_command_t;
+
+// Struct that is returned by the read() function
+struct Sony_data_t
+{
+    Sony_address_t address;
+    Sony_command_t command;
+    uint8_t length;
+};
+
+//==============================================================================
+// Sony Decoding Class
+//==============================================================================
+
+// Each instance number has its own decoding state and interrupt function.
+// Use different numbers (for example the pin number) for multiple receivers.
+template<uint8_t instance>
+class CSonyInstance : public CIRL_Receive<CSonyInstance<instance>>,
+                      public CIRL_Time<CSonyInstance<instance>>,
+                      public CIRL_Protocol<CSonyInstance<instance>, Sony_data_t>,
+                      public CIRL_DecodeMarks<CSonyInstance<instance>, SONY_BLOCKS>
+{
+protected:
+    static constexpr uint32_t timespanEvent = SONY_TIMESPAN_HOLDING;
+    static constexpr uint32_t limitTimeout = SONY_LIMIT_TIMEOUT;
+    static constexpr uint32_t limitLead = SONY_LIMIT_LEAD;
+    static constexpr uint32_t limitLogic = SONY_LIMIT_LOGIC;
+    static constexpr uint32_t limitSpace = SONY_LIMIT_SPACE;
+    static constexpr uint8_t irLength = SONY_LENGTH;
+
+    friend CIRL_Receive<CSonyInstance>;
+    friend CIRL_Time<CSonyInstance>;
+    template<class...> friend class CIRL_Multi;
+    friend CIRL_Protocol<CSonyInstance, Sony_data_t>;
+    friend CIRL_DecodeMarks<CSonyInstance, SONY_BLOCKS>;
+
+    // Protocol interface functions
+    static inline Sony_data_t getData(void);
+    static inline bool checksum(uint8_t length);
+
+    // Decoding buffer of this instance
+    using CIRL_DecodeMarks<CSonyInstance, SONY_BLOCKS>::data;
+    using CIRL_DecodeMarks<CSonyInstance, SONY_BLOCKS>::length;
+};
+
+// Default receiver
+typedef CSonyInstance<0> CSony;
+
+
+//==============================================================================
+// Sony Decoding Implementation
+//==============================================================================
+
+template<uint8_t instance>
+Sony_data_t CSonyInstance<instance>::getData(void) {
+    // Command is sent first (LSB first), followed by the address
+    uint32_t bits = ((uint32_t)data[2] << 16) |
+                    ((uint32_t)data[1] << 8) |
+                    ((uint32_t)data[0]);
+    // Remove data of older, longer frames
+    bits &= (1UL << length) - 1;
+
+    Sony_data_t retdata;
+    retdata.address = bits >> SONY_COMMAND_LENGTH;
+    retdata.command = bits & 0x7F;
+    retdata.length = length;
+    return retdata;
+}
+
+
+template<uint8_t instance>
+bool CSonyInstance<instance>::checksum(uint8_t length) {
+    // Sony has no checksum, only the frame length is checked
+    return length == SONY_DATA_LENGTH_12 ||
+           length == SONY_DATA_LENGTH_15 ||
+           length == SONY_DATA_LENGTH_20;
+}
@@ -26,30 +26,128 @@ THE SOFTWARE.
 
 #include "IRL_Platform.h"
 
+// Deferred decoding: the interrupt only saves the edge durations in a ring
+// buffer, decoding runs in the main loop via available()/read()/poll().
+// Define the buffer size (power of two, max 128) before including IRLremote.
+//#define IRL_DEFERRED_DECODE 32
+
+#ifdef IRL_DEFERRED_DECODE
+static_assert(IRL_DEFERRED_DECODE >= 4 && IRL_DEFERRED_DECODE <= 128 &&
+              (IRL_DEFERRED_DECODE & (IRL_DEFERRED_DECODE - 1)) == 0,
+              "IRL_DEFERRED_DECODE must be a power of two between 4 and 128");
+#endif
+
+// Glitch filter: two edges within this time (us) are a spike, both are
+// ignored and the durations around them are merged. Decoders that see every
+// edge get each edge once the next edge or the filter time has passed.
+// Decoders of a single edge type ignore an edge right after the last one.
+// Has to be shorter than the shortest mark and space of all used protocols.
+//#define IRL_GLITCH_FILTER 100
+
+#ifdef IRL_GLITCH_FILTER
+static_assert(IRL_GLITCH_FILTER > 0 && IRL_GLITCH_FILTER < 400,
+              "IRL_GLITCH_FILTER must be between 1 and 399us");
+#endif
+
 //==============================================================================
 // IRL_Time Class
 //==============================================================================
 
-template<class T>
+template<class T, class TB = IRL_Timebase>
 class CIRL_Time
 {
 public:
-    // User API to access library data
+    // Time source, all times and durations are measured in its ticks
+    typedef TB Timebase;
+
+    // User API to access library data.
+    // timeout() and nextEvent() return microseconds,
+    // lastEvent() returns ticks of the timebase.
     inline uint32_t timeout(void);
     inline uint32_t lastEvent(void);
     inline uint32_t nextEvent(void);
 
+#ifdef IRL_DEFERRED_DECODE
+    // Decode all edges that were captured by the interrupt
+    static inline void poll(void);
+#endif
+
     // Interface that is required to be implemented
     //static constexpr uint32_t timespanEvent = VALUE;
     //static constexpr uint32_t limitTimeout = VALUE;
+    //static inline void decode(uint16_t duration);
 
 protected:
     // Time mangement functions
     static inline uint16_t nextTime(void);
 
+    // Decodes the edge that the glitch filter holds back, once no spike can
+    // follow it anymore. Called by the main loop functions of the decoders.
+    static inline void release(void);
+
+    // Returns true if nextTime() has no edge to decode (IRL_GLITCH_FILTER)
+    static constexpr bool glitch(uint16_t duration) {
+#ifdef IRL_GLITCH_FILTER
+        return duration == 0;
+#else
+        return (void)duration, false;
+#endif
+    }
+
+    // Protocol limits (microseconds) in ticks, converted at compile time.
+    // Durations are saturated to 16 bit, so are the limits for durations.
+    static constexpr uint32_t timeLimit(uint32_t us) {
+        return Timebase::ticks(us);
+    }
+    static constexpr uint16_t durationLimit(uint32_t us) {
+        return Timebase::ticks(us) > 0xFFFF ? 0xFFFF : Timebase::ticks(us);
+    }
+
     // Time values for the last interrupt and the last valid protocol
     static uint32_t mlastTime;
     static volatile uint32_t mlastEvent;
+
+    // Saves the time of the decoded edge, returns the saturated duration
+    static inline uint16_t edgeDuration(uint32_t time);
+
+#ifdef IRL_GLITCH_FILTER
+    // Returns false if the edge at time is not decoded now. Otherwise time is
+    // set to the edge that is decoded, which is the held back edge for
+    // decoders that see every edge.
+    static inline bool filter(uint32_t &time);
+    static inline void releaseEdge(uint32_t time);
+
+    // Edge that is held back until it can not be part of a spike anymore
+    static volatile bool mpending;
+    static uint32_t mpendingTime;
+#endif
+
+    // Lock-free reads of the data that the interrupt writes. Every decoding
+    // interrupt changes the sequence, a reader retries if it was interrupted.
+    // The main loop never disables interrupts for reading.
+    static inline uint8_t sequence(void);
+    static inline bool changed(uint8_t start);
+    static volatile uint8_t msequence;
+
+#ifdef IRL_DEFERRED_DECODE
+    // Interrupt function that saves the edge duration for poll()
+    static inline void capture(void);
+
+    // Returns the time since the last decoded edge.
+    // Returns zero if new edges are pending.
+    static inline uint32_t idleTime(void);
+
+    // Single producer (interrupt), single consumer (main loop) ring buffer.
+    // Durations >= 0xFFFF are saved as 0xFFFF followed by the 32 bit value.
+    static volatile uint16_t mbuffer[IRL_DEFERRED_DECODE];
+    static volatile uint8_t mhead;
+    static volatile uint8_t mtail;
+    static uint32_t mcaptureTime;
+#ifdef IRL_GLITCH_FILTER
+    // Time of the last polled edge, the glitch filter may not decode it yet
+    static uint32_t medgeTime;
+#endif
+#endif
 };
 
 
@@ -58,8 +156,25 @@ protected:
 //==============================================================================
 
 // Protocol temporary data
-template<class T> uint32_t CIRL_Time<T>::mlastTime = 0;
-template<class T> volatile uint32_t CIRL_Time<T>::mlastEvent = 0;
+template<class T, class TB> uint32_t CIRL_Time<T, TB>::mlastTime = 0;
+template<class T, class TB> volatile uint32_t CIRL_Time<T, TB>::mlastEvent = 0;
+template<class T, class TB> volatile uint8_t CIRL_Time<T, TB>::msequence = 0;
+
+#ifdef IRL_GLITCH_FILTER
+template<class T, class TB> volatile bool CIRL_Time<T, TB>::mpending = false;
+template<class T, class TB> uint32_t CIRL_Time<T, TB>::mpendingTime = 0;
+#endif
+
+#ifdef IRL_DEFERRED_DECODE
+template<class T, class TB>
+volatile uint16_t CIRL_Time<T, TB>::mbuffer[IRL_DEFERRED_DECODE] = { 0 };
+template<class T, class TB> volatile uint8_t CIRL_Time<T, TB>::mhead = 0;
+template<class T, class TB> volatile uint8_t CIRL_Time<T, TB>::mtail = 0;
+template<class T, class TB> uint32_t CIRL_Time<T, TB>::mcaptureTime = 0;
+#ifdef IRL_GLITCH_FILTER
+template<class T, class TB> uint32_t CIRL_Time<T, TB>::medgeTime = 0;
+#endif
+#endif
 
 
 //==============================================================================
@@ -70,13 +185,33 @@ template<class T> volatile uint32_t CIRL_Time<T>::mlastEvent = 0;
  * Returns duration between last interrupt and current time.
  * This will safe the last interrupt time to the current time.
  */
-template<class T>
-uint16_t CIRL_Time<T>::nextTime(void){
-    // Save the duration between the last reading
-    uint32_t time = micros();
+template<class T, class TB>
+uint16_t CIRL_Time<T, TB>::nextTime(void){
+    uint32_t time = Timebase::edge();
+
+#ifdef IRL_GLITCH_FILTER
+    // Ignore the spike or hold back the edge
+    if (!filter(time)) {
+        return 0;
+    }
+#endif
+
+    return edgeDuration(time);
+}
+
+
+/*
+ * Saves the time of the decoded edge and returns its duration.
+ * The full 32 bit time is kept for the main loop timeouts.
+ */
+template<class T, class TB>
+uint16_t CIRL_Time<T, TB>::edgeDuration(uint32_t time){
     uint32_t duration_32 = time - mlastTime;
     mlastTime = time;
 
+    // The interrupt changes the decoding state, invalidate pending reads
+    msequence++;
+
     // Calculate 16 bit duration. On overflow sets duration to a clear timeout
     uint16_t duration = duration_32;
     if (duration_32 > 0xFFFF) {
@@ -87,37 +222,239 @@ uint16_t CIRL_Time<T>::nextTime(void){
 }
 
 
+#ifdef IRL_GLITCH_FILTER
+/*
+ * Decoders that see every edge get the edges one edge late. If the next edge
+ * follows within the filter time, both edges are a spike and are dropped.
+ * The durations before, of and after the spike are merged and the level of
+ * the following edges stays correct. Decoders of a single edge type can not
+ * see both edges of a spike, they drop an edge right after the last one.
+ */
+template<class T, class TB>
+bool CIRL_Time<T, TB>::filter(uint32_t &time)
+{
+    if (T::interruptMode != CHANGE) {
+        return time - mlastTime >= timeLimit(IRL_GLITCH_FILTER);
+    }
+
+    // Drop both edges of a spike
+    bool pending = mpending;
+    uint32_t pendingTime = mpendingTime;
+    if (pending && time - pendingTime < timeLimit(IRL_GLITCH_FILTER)) {
+        mpending = false;
+        return false;
+    }
+
+    // Hold back the new edge and decode the last one
+    mpending = true;
+    mpendingTime = time;
+    time = pendingTime;
+    return pending;
+}
+
+
+/*
+ * Decodes the held back edge if no spike can follow it anymore.
+ */
+template<class T, class TB>
+void CIRL_Time<T, TB>::releaseEdge(uint32_t time)
+{
+    if (mpending && time - mpendingTime >= timeLimit(IRL_GLITCH_FILTER)) {
+        mpending = false;
+        T::decode(edgeDuration(mpendingTime));
+    }
+}
+#endif
+
+
+template<class T, class TB>
+void CIRL_Time<T, TB>::release(void)
+{
+#ifdef IRL_GLITCH_FILTER
+    // The interrupt changes the held back edge
+    if (T::interruptMode == CHANGE && mpending) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            releaseEdge(Timebase::now());
+        }
+    }
+#endif
+}
+
+
+#ifdef IRL_DEFERRED_DECODE
+/*
+ * Saves the duration between the last and the current interrupt.
+ * This is the only work that is done inside the interrupt.
+ */
+template<class T, class TB>
+void CIRL_Time<T, TB>::capture(void)
+{
+    // Long durations require an escape value and the full 32 bit value
+    uint32_t time = Timebase::edge();
+    uint32_t duration = time - mcaptureTime;
+
+    uint8_t length = 1;
+    if (duration >= 0xFFFF) {
+        length = 3;
+    }
+
+    // Drop the edge if the buffer is full. Its duration is added to the
+    // next edge, so the time of the decoded edges stays correct.
+    uint8_t head = mhead;
+    if (uint8_t(head - mtail) > (IRL_DEFERRED_DECODE - length)) {
+        return;
+    }
+    mcaptureTime = time;
+
+    if (length == 1) {
+        mbuffer[head++ % IRL_DEFERRED_DECODE] = duration;
+    }
+    else {
+        mbuffer[head++ % IRL_DEFERRED_DECODE] = 0xFFFF;
+        mbuffer[head++ % IRL_DEFERRED_DECODE] = duration;
+        mbuffer[head++ % IRL_DEFERRED_DECODE] = duration >> 16;
+    }
+
+    // Publish the new entries
+    mhead = head;
+}
+
+
+/*
+ * Runs the protocol decoding for every captured edge.
+ * mlastTime is reconstructed from the durations and is the time of the
+ * currently decoded edge, like it is in the interrupt.
+ */
+template<class T, class TB>
+void CIRL_Time<T, TB>::poll(void)
+{
+    uint8_t tail = mtail;
+    while (tail != mhead)
+    {
+        uint32_t duration = mbuffer[tail++ % IRL_DEFERRED_DECODE];
+        if (duration == 0xFFFF) {
+            duration = mbuffer[tail++ % IRL_DEFERRED_DECODE];
+            duration |= uint32_t(mbuffer[tail++ % IRL_DEFERRED_DECODE]) << 16;
+        }
+
+        // Free the entries before decoding
+        mtail = tail;
+
+#ifdef IRL_GLITCH_FILTER
+        // Filter the edges here, the filter of decoders that see every edge
+        // keeps the last edge until the next one
+        uint32_t time = (medgeTime += duration);
+        if (filter(time)) {
+            T::decode(edgeDuration(time));
+        }
+#else
+        // Calculate 16 bit duration. On overflow sets duration to a clear timeout
+        mlastTime += duration;
+        if (duration > 0xFFFF) {
+            duration = 0xFFFF;
+        }
+        T::decode(duration);
+#endif
+    }
+
+#ifdef IRL_GLITCH_FILTER
+    // Decode the held back edge unless a newer edge was captured meanwhile
+    uint32_t time = Timebase::now();
+    if (T::interruptMode == CHANGE && tail == mhead) {
+        releaseEdge(time);
+    }
+#endif
+}
+
+
+template<class T, class TB>
+uint32_t CIRL_Time<T, TB>::idleTime(void)
+{
+    poll();
+
+    // If an edge was captured after polling, we are still receiving.
+    // Otherwise all edges before the current time are decoded.
+    uint32_t time = Timebase::now();
+    if (mhead != mtail) {
+        return 0;
+    }
+#ifdef IRL_GLITCH_FILTER
+    // The held back edge is younger than the filter time
+    if (mpending) {
+        return 0;
+    }
+#endif
+    return time - mlastTime;
+}
+#endif
+
+
+template<class T, class TB>
+uint8_t CIRL_Time<T, TB>::sequence(void)
+{
+    uint8_t ret = msequence;
+    IRL_MEMORY_BARRIER();
+    return ret;
+}
+
+
+/*
+ * Returns true if an interrupt changed the data since sequence().
+ * The interrupt can not be interrupted by the main loop,
+ * so a single counter without odd/even states is enough.
+ */
+template<class T, class TB>
+bool CIRL_Time<T, TB>::changed(uint8_t start)
+{
+    IRL_MEMORY_BARRIER();
+    return start != msequence;
+}
+
+
 /*
  * Return relativ time between last event time (in micros)
  */
-template<class T>
-uint32_t CIRL_Time<T>::timeout(void)
+template<class T, class TB>
+uint32_t CIRL_Time<T, TB>::timeout(void)
 {
     uint32_t timeout;
 
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
-    {
+#ifdef IRL_DEFERRED_DECODE
+    // Events are detected in the main loop
+    poll();
+#endif
+
+    uint8_t s;
+    do {
+        s = sequence();
         timeout = mlastEvent;
-    }
+    } while (changed(s));
 
-    uint32_t time = micros();
+    uint32_t time = Timebase::now();
     timeout = time - timeout;
 
-    return timeout;
+    return Timebase::micros(timeout);
 }
 
 
 /*
- * Return absolute last event time (in micros)
+ * Return absolute last event time (in ticks of the timebase)
  */
-template<class T>
-uint32_t CIRL_Time<T>::lastEvent(void)
+template<class T, class TB>
+uint32_t CIRL_Time<T, TB>::lastEvent(void)
 {
     uint32_t time;
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
-    {
+
+#ifdef IRL_DEFERRED_DECODE
+    // Events are detected in the main loop
+    poll();
+#endif
+    uint8_t s;
+    do {
+        s = sequence();
         time = mlastEvent;
-    }
+    } while (changed(s));
 
     return time;
 }
@@ -129,8 +466,8 @@ uint32_t CIRL_Time<T>::lastEvent(void)
  * Attention! This value is a little bit too high in general.
  * Also for the first press it is even higher than it should.
  */
-template<class T>
-uint32_t CIRL_Time<T>::nextEvent(void)
+template<class T, class TB>
+uint32_t CIRL_Time<T, TB>::nextEvent(void)
 {
     auto time = timeout();
     auto timespan = static_cast<T*>(this)->timespanEvent;
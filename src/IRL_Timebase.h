@@ -0,0 +1,132 @@
+/*
+Copyright (c) 2014-2018 NicoHood
+See the readme for credit to other people.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+// Include guard
+#pragma once
+
+#include "IRL_Platform.h"
+#include "IRL_TimerCapture.h"
+
+//==============================================================================
+// Timebase Definitions
+//==============================================================================
+
+// A timebase is the time source of the receivers. All durations, times and
+// protocol limits are measured in its ticks. The limits are converted from
+// microseconds at compile time, so the interrupt does not convert units.
+//
+// Interface of a timebase:
+//static inline uint32_t now(void);          // Current time
+//static inline uint32_t edge(void);         // Time of the edge (interrupt)
+//static constexpr uint32_t ticks(uint32_t us);  // Microseconds to ticks
+//static inline uint32_t micros(uint32_t ticks); // Ticks to microseconds
+//
+// The times wrap around at 32 bit. The default is micros() or Timer1 with
+// IRL_TIMER_CAPTURE. Define a different timebase before including IRLremote:
+//#define IRL_TIMEBASE IRL_TimebaseCycles<3>
+
+//==============================================================================
+// IRL_TimebaseMicros
+//==============================================================================
+
+struct IRL_TimebaseMicros
+{
+    static inline uint32_t now(void) {
+        return ::micros();
+    }
+    static inline uint32_t edge(void) {
+        return ::micros();
+    }
+    static constexpr uint32_t ticks(uint32_t us) {
+        return us;
+    }
+    static inline uint32_t micros(uint32_t ticks) {
+        return ticks;
+    }
+};
+
+//==============================================================================
+// IRL_TimebaseTimer1
+//==============================================================================
+
+#ifdef IRL_TIMER_CAPTURE
+// Prescaled 16 bit hardware timer, 0.5us ticks at 16MHz
+struct IRL_TimebaseTimer1
+{
+    static inline uint32_t now(void) {
+        return CIRL_TimerCapture::now();
+    }
+    static inline uint32_t edge(void) {
+        return CIRL_TimerCapture::edgeTime();
+    }
+    static constexpr uint32_t ticks(uint32_t us) {
+        return us * CIRL_TimerCapture::ticks;
+    }
+    static inline uint32_t micros(uint32_t ticks) {
+        return ticks / CIRL_TimerCapture::ticks;
+    }
+};
+#endif
+
+//==============================================================================
+// IRL_TimebaseCycles
+//==============================================================================
+
+#ifdef IRL_HOST
+// CPU cycle counter of the virtual host clock, divided by 2^shift
+#ifndef IRL_HOST_F_CPU
+#define IRL_HOST_F_CPU 16000000ULL
+#endif
+
+template<uint8_t shift>
+struct IRL_TimebaseCycles
+{
+    static_assert(shift < 32, "IRL_TimebaseCycles: shift is too big");
+
+    static inline uint32_t now(void) {
+        return (uint64_t(::micros()) * (IRL_HOST_F_CPU / 1000000ULL)) >> shift;
+    }
+    static inline uint32_t edge(void) {
+        return now();
+    }
+    static constexpr uint32_t ticks(uint32_t us) {
+        return (uint64_t(us) * (IRL_HOST_F_CPU / 1000000ULL)) >> shift;
+    }
+    static inline uint32_t micros(uint32_t ticks) {
+        return (uint64_t(ticks) << shift) / (IRL_HOST_F_CPU / 1000000ULL);
+    }
+};
+#endif
+
+//==============================================================================
+// Default Timebase
+//==============================================================================
+
+#if defined(IRL_TIMEBASE)
+typedef IRL_TIMEBASE IRL_Timebase;
+#elif defined(IRL_TIMER_CAPTURE)
+typedef IRL_TimebaseTimer1 IRL_Timebase;
+#else
+typedef IRL_TimebaseMicros IRL_Timebase;
+#endif
@@ -0,0 +1,301 @@
+/*
+Copyright (c) 2014-2018 NicoHood
+See the readme for credit to other people.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+// Include guard
+#pragma once
+
+#include "IRL_Platform.h"
+
+//==============================================================================
+// Timer Capture Definitions
+//==============================================================================
+
+// Hardware input capture: Timer1 latches the time of every edge on its
+// input capture pin (ICP1), the interrupt only reads the latched value.
+// The durations are exact (0.5us at 16MHz) and independent of the interrupt
+// latency and micros() is not called inside the interrupt anymore.
+// Timer1 runs with a prescaler of 8 and is used as timebase of the library,
+// all durations are measured in timer ticks (see IRL_Timebase.h).
+// It can not be combined with other Timer1 users (Servo, IRL_PROFILER),
+// sending with IRL_Send.h shares the timer.
+// Only a single receiver on the capture pin is possible.
+// Place IRL_TIMER_CAPTURE_INTERRUPTS in a single source file, it defines the
+// capture and overflow interrupts.
+// Experimental: not verified on hardware or in a simulator yet.
+// Define before including IRLremote.
+//#define IRL_TIMER_CAPTURE
+
+#ifdef IRL_TIMER_CAPTURE
+
+#if defined(IRL_HOST)
+// Any pin, the edge time is the virtual time of the edge
+#elif defined(ARDUINO_ARCH_AVR) && defined(ICR1)
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || \
+    defined(__AVR_ATmega168__) || defined(__AVR_ATmega88__)
+#define IRL_TIMER_CAPTURE_PIN 8
+#elif defined(__AVR_ATmega32U4__)
+#define IRL_TIMER_CAPTURE_PIN 4
+#else
+#error "IRL_TIMER_CAPTURE: the input capture pin of this board is not known."
+#endif
+#ifdef IRL_PROFILER
+#error "IRL_TIMER_CAPTURE and IRL_PROFILER both require Timer1."
+#endif
+#if F_CPU != 16000000UL && F_CPU != 8000000UL
+#error "IRL_TIMER_CAPTURE requires F_CPU of 8 or 16MHz."
+#endif
+#else
+#error "IRL_TIMER_CAPTURE is only supported on AVR with Timer1."
+#endif
+
+//==============================================================================
+// IRL_TimerCapture Class
+//==============================================================================
+
+// Only Timer1 is implemented. The template keeps the static data in the header.
+template<uint8_t timer>
+class CIRL_TimerCaptureInstance
+{
+    static_assert(timer == 1, "Only Timer1 is supported");
+
+public:
+    // Starts the timer and calls the function on every edge (mode)
+    static inline bool begin(uint8_t pin, void (*function)(void), uint8_t mode);
+    static inline bool end(uint8_t pin);
+
+    // Current time in timer ticks
+    static inline uint32_t now(void);
+
+    // Time of the current edge in timer ticks, latched by the hardware
+    static inline uint32_t edgeTime(void);
+
+    // Interrupt functions
+    static inline void interrupt(void);
+    static inline void overflow(void);
+
+    // Timer1 ticks per microsecond with a prescaler of 8.
+    // The host emulates a 16MHz board.
+#ifdef IRL_HOST
+    static constexpr uint8_t ticks = 2;
+#else
+    static constexpr uint8_t ticks = F_CPU / 8000000UL;
+#endif
+
+protected:
+#ifndef IRL_HOST
+    static inline uint32_t time(uint16_t count, uint16_t overflows);
+
+    static volatile uint16_t moverflows;
+    static bool mchange;
+    static uint32_t medgeTime;
+#endif
+
+    static void (*mfunction)(void);
+};
+
+typedef CIRL_TimerCaptureInstance<1> CIRL_TimerCapture;
+
+//==============================================================================
+// Static Data
+//==============================================================================
+
+#ifndef IRL_HOST
+template<uint8_t timer>
+volatile uint16_t CIRL_TimerCaptureInstance<timer>::moverflows = 0;
+template<uint8_t timer>
+bool CIRL_TimerCaptureInstance<timer>::mchange = false;
+template<uint8_t timer>
+uint32_t CIRL_TimerCaptureInstance<timer>::medgeTime = 0;
+#endif
+template<uint8_t timer>
+void (*CIRL_TimerCaptureInstance<timer>::mfunction)(void) = nullptr;
+
+//==============================================================================
+// CIRL_TimerCapture Implementation
+//==============================================================================
+
+#ifdef IRL_HOST
+template<uint8_t timer>
+bool CIRL_TimerCaptureInstance<timer>::begin(uint8_t pin, void (*function)(void), uint8_t mode)
+{
+    // Only a single receiver is possible
+    if (mfunction && mfunction != function) {
+        return false;
+    }
+    mfunction = function;
+    pinMode(pin, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(pin), interrupt, mode);
+    return true;
+}
+
+
+template<uint8_t timer>
+bool CIRL_TimerCaptureInstance<timer>::end(uint8_t pin)
+{
+    pinMode(pin, INPUT);
+    detachInterrupt(digitalPinToInterrupt(pin));
+    mfunction = nullptr;
+    return true;
+}
+
+
+template<uint8_t timer>
+uint32_t CIRL_TimerCaptureInstance<timer>::now(void)
+{
+    return ::micros() * ticks;
+}
+
+
+// The edges of the virtual clock happen at the current time. CIRL_Batch
+// also decodes edges without an interrupt, so nothing is latched.
+template<uint8_t timer>
+uint32_t CIRL_TimerCaptureInstance<timer>::edgeTime(void)
+{
+    return now();
+}
+
+
+template<uint8_t timer>
+void CIRL_TimerCaptureInstance<timer>::interrupt(void)
+{
+    mfunction();
+}
+
+
+template<uint8_t timer>
+void CIRL_TimerCaptureInstance<timer>::overflow(void) {}
+
+// The host calls the interrupt function directly
+#define IRL_TIMER_CAPTURE_INTERRUPTS
+
+#else
+template<uint8_t timer>
+bool CIRL_TimerCaptureInstance<timer>::begin(uint8_t pin, void (*function)(void), uint8_t mode)
+{
+    // Only a single receiver on the capture pin is possible
+    if (pin != IRL_TIMER_CAPTURE_PIN || mode == LOW ||
+        (mfunction && mfunction != function)) {
+        return false;
+    }
+    pinMode(pin, INPUT_PULLUP);
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        mfunction = function;
+
+        // Normal mode, prescaler 8, noise canceler. The idle level is HIGH,
+        // capture the falling edge first (or only the rising edge).
+        mchange = mode == CHANGE;
+        TCCR1A = 0;
+        TCCR1B = _BV(ICNC1) | _BV(CS11) | (mode == RISING ? _BV(ICES1) : 0);
+        TIFR1 = _BV(ICF1) | _BV(TOV1);
+        TIMSK1 |= _BV(ICIE1) | _BV(TOIE1);
+    }
+    return true;
+}
+
+
+template<uint8_t timer>
+bool CIRL_TimerCaptureInstance<timer>::end(uint8_t pin)
+{
+    if (pin != IRL_TIMER_CAPTURE_PIN) {
+        return false;
+    }
+    pinMode(pin, INPUT);
+
+    // The timer keeps running as time source
+    TIMSK1 &= ~_BV(ICIE1);
+    mfunction = nullptr;
+    return true;
+}
+
+
+template<uint8_t timer>
+uint32_t CIRL_TimerCaptureInstance<timer>::time(uint16_t count, uint16_t overflows)
+{
+    // An overflow is pending if the counter wrapped, but the interrupt
+    // was not executed yet
+    if ((TIFR1 & _BV(TOV1)) && count < 0x8000) {
+        overflows++;
+    }
+
+    // The overflows are the upper 16 bit, no multiplication or division
+    return (uint32_t(overflows) << 16) | count;
+}
+
+
+template<uint8_t timer>
+uint32_t CIRL_TimerCaptureInstance<timer>::now(void)
+{
+    uint32_t ret;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        ret = time(TCNT1, moverflows);
+    }
+    return ret;
+}
+
+
+template<uint8_t timer>
+uint32_t CIRL_TimerCaptureInstance<timer>::edgeTime(void)
+{
+    return medgeTime;
+}
+
+
+template<uint8_t timer>
+void CIRL_TimerCaptureInstance<timer>::interrupt(void)
+{
+    uint16_t count = ICR1;
+
+    // Capture the other edge next, the flag is set when the edge is changed
+    if (mchange) {
+        TCCR1B ^= _BV(ICES1);
+        TIFR1 = _BV(ICF1);
+    }
+
+    medgeTime = time(count, moverflows);
+    mfunction();
+}
+
+
+template<uint8_t timer>
+void CIRL_TimerCaptureInstance<timer>::overflow(void)
+{
+    moverflows++;
+}
+
+
+// Timer1 capture and overflow interrupts, only used in a single source file.
+// A definition in this header would be duplicated in every file including it.
+#define IRL_TIMER_CAPTURE_INTERRUPTS \
+    ISR(TIMER1_CAPT_vect) { \
+        CIRL_TimerCapture::interrupt(); \
+    } \
+    ISR(TIMER1_OVF_vect) { \
+        CIRL_TimerCapture::overflow(); \
+    }
+#endif
+
+#endif
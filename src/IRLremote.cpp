@@ -27,7 +27,20 @@ THE SOFTWARE.
 // Static Data
 //==============================================================================
 
-// Protocol temporary data
-volatile uint8_t CHashIR::count = 0;
-uint32_t CHashIR::hash = FNV_BASIS_32;
-volatile uint16_t CHashIR::lastDuration = 0xFFFF;
+#ifdef IRL_HOST
+// Virtual clock and simulated pins
+uint32_t CIRL_Host::mtime = 0;
+uint8_t CIRL_Host::mlevel[IRL_HOST_PINS] = { 0 };
+uint8_t CIRL_Host::mmode[IRL_HOST_PINS] = { 0 };
+IRL_HostInterrupt CIRL_Host::misr[IRL_HOST_PINS] = { nullptr };
+
+// Timer interrupt and sender output
+uint32_t CIRL_Host::mtimerTime = 0;
+IRL_HostInterrupt CIRL_Host::mtimerIsr = nullptr;
+bool CIRL_Host::mcarrier = false;
+uint8_t CIRL_Host::mloopback = 0xFF;
+uint32_t CIRL_Host::mfrequency = 0;
+uint32_t CIRL_Host::mtimelineTime[IRL_HOST_TIMELINE] = { 0 };
+bool CIRL_Host::mtimelineCarrier[IRL_HOST_TIMELINE] = { false };
+uint16_t CIRL_Host::mtimelineLength = 0;
+#endif
@@ -44,7 +44,19 @@ THE SOFTWARE.
 #include "IRL_Nec.h"
 #include "IRL_NecAPI.h"
 #include "IRL_Panasonic.h"
+#include "IRL_Sony.h"
+#include "IRL_RC5.h"
+#include "IRL_RC6.h"
 #include "IRL_Hash.h"
 
+// Decode multiple protocols on a single pin
+#include "IRL_Multi.h"
+
+// Press, hold and release events for any protocol
+#include "IRL_Events.h"
+
+// Map learned HashIR codes to actions
+#include "IRL_HashTable.h"
+
 // Include pre recorded IR codes from IR remotes
 #include "IRL_Keycodes.h"